@@ -0,0 +1,34 @@
+#ifndef SUPER_HAXAGON_ALLOCATIONS_HPP
+#define SUPER_HAXAGON_ALLOCATIONS_HPP
+
+#include <cstdint>
+
+namespace SuperHaxagon {
+	/**
+	 * Counts heap allocations made by the calling thread. Built with
+	 * SUPER_HAXAGON_ALLOC_TRACK this replaces the global operator new,
+	 * otherwise it counts nothing and costs nothing. The profiler splits
+	 * the counts up by frame and zone.
+	 */
+	class Allocations {
+	public:
+		struct Count {
+			uint64_t allocs;
+			uint64_t bytes;
+		};
+
+#ifdef SUPER_HAXAGON_ALLOC_TRACK
+		static constexpr bool TRACKING = true;
+
+		/**
+		 * Everything the calling thread has allocated since it started
+		 */
+		static Count get();
+#else
+		static constexpr bool TRACKING = false;
+		static Count get() {return {0, 0};}
+#endif
+	};
+}
+
+#endif //SUPER_HAXAGON_ALLOCATIONS_HPP
@@ -0,0 +1,85 @@
+#ifndef SUPER_HAXAGON_ASSET_CACHE_HPP
+#define SUPER_HAXAGON_ASSET_CACHE_HPP
+
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#ifndef SUPER_HAXAGON_NO_THREADS
+#include <mutex>
+#endif
+
+namespace SuperHaxagon {
+	class AudioLoader;
+	class Metadata;
+	class Platform;
+	enum class Location;
+
+	/**
+	 * Recently used BGM loaders and timelines, so going back to a song
+	 * does not open and parse it all over again.
+	 *
+	 * Entries are kept in least recently used order, and the oldest are
+	 * dropped once their total size goes over the budget. Anything still
+	 * playing stays alive through its shared_ptr after it is dropped.
+	 * The cache is filled from the worker and may be asked about from the
+	 * game thread, so every call takes a lock.
+	 */
+	class AssetCache {
+	public:
+		static constexpr size_t DEFAULT_BUDGET = 2 * 1024 * 1024;
+
+		explicit AssetCache(Platform& platform, size_t budget = DEFAULT_BUDGET);
+		AssetCache(AssetCache&) = delete;
+		~AssetCache();
+
+		/**
+		 * Gets the loader of a BGM, opening it if it is not cached
+		 */
+		std::shared_ptr<AudioLoader> getAudio(const std::string& base, Location location);
+
+		/**
+		 * Gets a copy of a BGM's timeline that is ready to play from the
+		 * start, reading it if it is not cached
+		 */
+		std::unique_ptr<Metadata> getMetadata(const std::string& base, Location location);
+
+		/**
+		 * Makes sure both the loader and the timeline of a BGM are cached
+		 */
+		void prefetch(const std::string& base, Location location);
+
+		void setBudget(size_t budget);
+		size_t getSize() const;
+
+	private:
+		struct Entry {
+			std::string key;
+			std::shared_ptr<AudioLoader> audio;
+			std::shared_ptr<const Metadata> metadata;
+			size_t size;
+		};
+
+		using Entries = std::list<Entry>;
+
+		std::shared_ptr<const Metadata> loadMetadata(const std::string& base, Location location);
+		Entry* find(const std::string& key);
+		void insert(Entry entry);
+		void trim();
+
+		Platform& _platform;
+		size_t _budget;
+		size_t _size = 0;
+
+		// Most recently used first
+		Entries _entries;
+		std::unordered_map<std::string, Entries::iterator> _index;
+
+#ifndef SUPER_HAXAGON_NO_THREADS
+		mutable std::mutex _mutex;
+#endif
+	};
+}
+
+#endif //SUPER_HAXAGON_ASSET_CACHE_HPP
@@ -1,7 +1,11 @@
 #ifndef SUPER_HAXAGON_AUDIO_LOADER_HPP
 #define SUPER_HAXAGON_AUDIO_LOADER_HPP
 
+#include "Core/Memory.hpp"
+
+#include <cstddef>
 #include <memory>
+#include <utility>
 
 namespace SuperHaxagon {
 	enum class Stream {
@@ -19,6 +23,27 @@ namespace SuperHaxagon {
 		virtual ~AudioLoader() = default;
 
 		virtual std::unique_ptr<AudioPlayer> instantiate() = 0;
+
+		/**
+		 * Roughly how many bytes the loader holds on to, for caches to budget with
+		 */
+		virtual size_t getSize() const {return 0;}
+
+		/**
+		 * When every SFX voice is busy, a sound can only take over a voice
+		 * playing something of the same or lower priority.
+		 */
+		void setPriority(const int priority) {_priority = priority;}
+		int getPriority() const {return _priority;}
+
+		/**
+		 * Held for as long as the loader is, see getSize()
+		 */
+		void setCharge(MemoryCharge charge) {_charge = std::move(charge);}
+
+	private:
+		int _priority = 0;
+		MemoryCharge _charge;
 	};
 }
 
@@ -14,6 +14,11 @@ namespace SuperHaxagon {
 		virtual void pause() = 0;
 		virtual bool isDone() const = 0;
 		virtual float getTime() const = 0;
+
+		/**
+		 * Volume from 0 to 1. Players that cannot change it ignore this.
+		 */
+		virtual void setVolume(float) {}
 	};
 }
 
@@ -0,0 +1,74 @@
+#ifndef SUPER_HAXAGON_AUDIO_SINK_HPP
+#define SUPER_HAXAGON_AUDIO_SINK_HPP
+
+#ifndef SUPER_HAXAGON_NO_THREADS
+
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace SuperHaxagon {
+	class Mixer;
+
+	/**
+	 * Stands in for an audio device. A thread pulls a period from the
+	 * mixer in real time, exactly like a device callback would, so the
+	 * mixer's cost and underruns can be measured without any hardware.
+	 */
+	class AudioSink {
+	public:
+		static constexpr size_t PERIOD_FRAMES = 512;
+
+		explicit AudioSink(Mixer& mixer);
+		AudioSink(AudioSink&) = delete;
+		virtual ~AudioSink();
+
+		uint64_t getFrames() const {return _frames.load(std::memory_order_relaxed);}
+
+	protected:
+		// Derived sinks start pulling once they are ready, and stop before they are torn down
+		void start();
+		void stop();
+
+		virtual void consume(const int16_t* samples, size_t frames) = 0;
+
+		Mixer& _mixer;
+
+	private:
+		std::vector<int16_t> _period;
+		std::atomic<uint64_t> _frames{0};
+		std::atomic<bool> _running{false};
+		std::thread _thread;
+	};
+
+	class NullSink : public AudioSink {
+	public:
+		explicit NullSink(Mixer& mixer);
+		~NullSink() override;
+
+	protected:
+		void consume(const int16_t*, size_t) override {}
+	};
+
+	class WavSink : public AudioSink {
+	public:
+		WavSink(Mixer& mixer, const std::string& path);
+		~WavSink() override;
+
+		bool isOpen() const {return static_cast<bool>(_file);}
+
+	protected:
+		void consume(const int16_t* samples, size_t frames) override;
+
+	private:
+		std::ofstream _file;
+		uint32_t _written = 0;
+	};
+}
+
+#endif
+
+#endif //SUPER_HAXAGON_AUDIO_SINK_HPP
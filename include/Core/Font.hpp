@@ -1,7 +1,11 @@
 #ifndef SUPER_HAXAGON_FONT_HPP
 #define SUPER_HAXAGON_FONT_HPP
 
+#include "Core/Memory.hpp"
+
+#include <cstddef>
 #include <string>
+#include <utility>
 
 namespace SuperHaxagon {
 	enum class Alignment {
@@ -23,6 +27,19 @@ namespace SuperHaxagon {
 		virtual float getHeight() const = 0;
 		virtual float getWidth(const std::string& str) const = 0;
 		virtual void draw(const Color& color, const Point& position, Alignment alignment, const std::string& text) = 0;
+
+		/**
+		 * Roughly how many bytes of glyphs the font holds on to itself
+		 */
+		virtual size_t getSize() const {return 0;}
+
+		/**
+		 * Held for as long as the font is, see getSize()
+		 */
+		void setCharge(MemoryCharge charge) {_charge = std::move(charge);}
+
+	private:
+		MemoryCharge _charge;
 	};
 }
 
@@ -0,0 +1,84 @@
+#ifndef SUPER_HAXAGON_FRAME_PACER_HPP
+#define SUPER_HAXAGON_FRAME_PACER_HPP
+
+#include <array>
+#include <chrono>
+
+namespace SuperHaxagon {
+	/**
+	 * Works out when the next frame has to start so that it is done just
+	 * before the display wants it, for platforms that block on vsync.
+	 * Starting late instead of right after the last present means input
+	 * is read closer to when the frame is seen, and every frame spends
+	 * the same time waiting.
+	 *
+	 * It first lets frames run free to learn the refresh rate from how
+	 * far apart presents are. If they come too close together vsync is
+	 * off, and it does not pace at all. A run of missed or early presents
+	 * starts it learning again, such as when the window moves to another
+	 * display.
+	 */
+	class FramePacer {
+	public:
+		using Clock = std::chrono::steady_clock;
+
+		static constexpr size_t CALIBRATE_FRAMES = 60;
+		static constexpr size_t RECALIBRATE_MISSES = 30;
+		static constexpr float MIN_PERIOD = 1.0f / 500.0f; // Any faster and vsync is off
+		static constexpr float MAX_PERIOD = 1.0f / 24.0f;  // Any slower and there is nothing to gain
+		static constexpr float WORK_DECAY = 0.98f;         // A frame, for how fast a slow frame is forgotten
+		static constexpr float MARGIN = 0.002f;            // Seconds left spare before the deadline
+
+		enum class State {
+			CALIBRATING,
+			PACING,
+			OFF
+		};
+
+		FramePacer() = default;
+		FramePacer(FramePacer&) = delete;
+
+		/**
+		 * Learns the refresh rate again
+		 */
+		void reset();
+
+		/**
+		 * Call once the wait is over, just before input is read
+		 */
+		void begin(Clock::time_point now);
+
+		/**
+		 * Call with the times from either side of the call that blocks
+		 * on vsync. True if the pacer just changed state.
+		 */
+		bool presented(Clock::time_point before, Clock::time_point after);
+
+		/**
+		 * When to start the next frame, while pacing
+		 */
+		Clock::time_point getWake() const;
+
+		State getState() const {return _state;}
+		float getPeriod() const {return _period;}
+
+		/**
+		 * From reading input to the frame being presented, in seconds
+		 */
+		float getLatency() const {return _latency;}
+
+	private:
+		std::array<float, CALIBRATE_FRAMES> _intervals{};
+		size_t _samples = 0;
+		size_t _misses = 0;
+
+		State _state = State::CALIBRATING;
+		Clock::time_point _begin{};
+		Clock::time_point _presented{};
+		float _period = 0;
+		float _work = 0;
+		float _latency = 0;
+	};
+}
+
+#endif //SUPER_HAXAGON_FRAME_PACER_HPP
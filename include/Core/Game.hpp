@@ -1,8 +1,11 @@
 #ifndef SUPER_HAXAGON_GAME_HPP
 #define SUPER_HAXAGON_GAME_HPP
 
+#include <array>
+#include <cstdint>
 #include <deque>
 #include <memory>
+#include <utility>
 #include <vector>
 #include <string>
 
@@ -12,6 +15,7 @@ namespace SuperHaxagon {
 	struct Color;
 	class LevelFactory;
 	class AudioLoader;
+	class AudioPlayer;
 	class State;
 	class Pattern;
 	class Wall;
@@ -19,10 +23,37 @@ namespace SuperHaxagon {
 	class Twist;
 	class Font;
 	class Metadata;
+	class Scores;
+	class History;
+	class AssetCache;
+	class Worker;
+	class Jobs;
+	class Overlay;
+	class QualityGovernor;
 	enum class Location;
 
 	class Game {
 	public:
+		// How long a crossfade between two BGMs takes, at 60 frames a second
+		static constexpr float BGM_FADE_FRAMES = 60.0f;
+
+		// Anything measured beyond this is a bad calibration, in seconds
+		static constexpr float MAX_LATENCY = 0.5f;
+
+		// Effects that can be held back by the latency at once, any more play straight away
+		static constexpr size_t MAX_DELAYED_SFX = 16;
+
+		// Frames a steady state gets to settle in before it has to stop allocating
+		static constexpr uint32_t STEADY_FRAMES = 60;
+
+		// Walls on screen before their geometry is worth splitting across
+		// threads, and how many each thread takes at a time. See JobsBench.
+		static constexpr size_t PARALLEL_WALLS = 256;
+		static constexpr size_t WALL_GRAIN = 64;
+
+		static const char* LATENCY_HEADER;
+		static const char* LATENCY_FOOTER;
+
 		explicit Game(Platform& platform);
 		Game(const Game&) = delete;
 		~Game();
@@ -31,6 +62,11 @@ namespace SuperHaxagon {
 
 		Platform& getPlatform() const {return _platform;}
 		Twist& getTwister() const {return *_twister;}
+		Scores& getScores() const {return *_scores;}
+		History& getHistory() const {return *_history;}
+		AssetCache& getCache() const {return *_cache;}
+		Jobs& getJobs() const {return *_jobs;}
+		QualityGovernor& getQuality() const {return *_quality;}
 		AudioLoader& getSFXBegin() const {return *_sfxBegin;}
 		AudioLoader& getSFXHexagon() const {return *_sfxHexagon;}
 		AudioLoader& getSFXOver() const {return *_sfxOver;}
@@ -39,11 +75,47 @@ namespace SuperHaxagon {
 		AudioLoader& getSFXWonderful() const {return *_sfxWonderful;}
 		AudioLoader* getBGMAudio() const {return _bgmAudio.get();}
 		Metadata* getBGMMetadata() const {return _bgmMetadata.get();}
+		float getLatency() const {return _latency;}
 		Font& getFontSmall() const;
 		Font& getFontLarge() const;
 		float getScreenDimMax() const;
 		float getScreenDimMin() const;
-		void loadBGMAudio(const std::string& music, Location location, bool loadMetadata);
+
+		/**
+		 * Opens and primes a BGM on a background job. It replaces the
+		 * current one once it is ready, fading across if crossfade is set.
+		 * If loadMetadata is false, the old metadata is kept.
+		 */
+		void loadBGMAudio(const std::string& music, Location location, bool loadMetadata, bool crossfade = false);
+
+		/**
+		 * True until the last requested BGM is playing. States that need the
+		 * new BGM wait on this before moving on.
+		 */
+		bool isBGMLoading();
+
+		/**
+		 * Opens a BGM and reads its timeline on a background job so a
+		 * later loadBGMAudio() of it finds them in the cache
+		 */
+		void prefetchBGM(const std::string& music, Location location);
+
+		/**
+		 * Plays a sound effect so it is heard together with what is drawn
+		 * this frame, holding it back if the screen lags behind the speakers
+		 */
+		void playSFX(AudioLoader& audio);
+
+		/**
+		 * Reads the latency calibration from the user directory, if there is one
+		 */
+		void loadLatency();
+
+		/**
+		 * Sets how many seconds the screen lags behind the speakers and
+		 * saves it to the user directory. Negative if the speakers are later.
+		 */
+		void setLatency(float latency);
 
 		void setRunning(const bool running) {_running = running;}
 		void setSkew(const float skew) {_skew = skew;}
@@ -54,6 +126,12 @@ namespace SuperHaxagon {
 		 */
 		void run();
 
+		/**
+		 * Frames that allocated after a steady state settled in. Only
+		 * counted when built with SUPER_HAXAGON_ALLOC_TRACK.
+		 */
+		uint32_t getSteadyAllocations() const {return _steadyAllocations;}
+
 		/**
 		 * Loads a level into the game
 		 */
@@ -109,11 +187,20 @@ namespace SuperHaxagon {
 		void skew(std::vector<Point>& skew) const;
 
 	private:
+		struct PendingBGM;
+
+		void updateBGM(float dilation);
+		void updateSFX(float dilation);
+		void toggleOverlay();
+		void checkAllocations();
+
 		Platform& _platform;
 
 		std::vector<std::unique_ptr<LevelFactory>> _levels;
 
 		std::unique_ptr<Twist> _twister;
+		std::unique_ptr<Scores> _scores;
+		std::unique_ptr<History> _history;
 		std::unique_ptr<State> _state;
 
 		// Should really be an array of sfx
@@ -123,13 +210,41 @@ namespace SuperHaxagon {
 		std::unique_ptr<AudioLoader> _sfxSelect;
 		std::unique_ptr<AudioLoader> _sfxLevelUp;
 		std::unique_ptr<AudioLoader> _sfxWonderful;
+
+		// Effects held back by the latency, and how many frames they still have to wait
+		std::array<std::pair<AudioLoader*, float>, MAX_DELAYED_SFX> _sfxDelayed{};
+		size_t _sfxDelayedCount = 0;
+		float _latency = 0.0f;
 		
-		std::unique_ptr<AudioLoader> _bgmAudio;
+		// Loaders are shared with the cache
+		std::shared_ptr<AudioLoader> _bgmAudio;
 		std::unique_ptr<Metadata> _bgmMetadata;
+
+		// The outgoing BGM during a crossfade, and the loader it came from
+		std::shared_ptr<AudioLoader> _bgmFadingAudio;
+		std::unique_ptr<AudioPlayer> _bgmFading;
+		float _bgmFade = 0.0f; // Frames into the crossfade
+
+		std::unique_ptr<AssetCache> _cache;
+		std::shared_ptr<PendingBGM> _bgmPending;
+		std::unique_ptr<Worker> _worker;
+		std::unique_ptr<Jobs> _jobs;
+		std::unique_ptr<QualityGovernor> _quality;
+
+		// Kept between frames so dense levels do not allocate while drawing
+		mutable std::vector<const Wall*> _drawWalls;
+		mutable std::vector<std::vector<Point>> _drawQuads;
 		
 		std::unique_ptr<Font> _small;
 		std::unique_ptr<Font> _large;
 
+		std::unique_ptr<Overlay> _overlay;
+		bool _overlayShown = false;
+		bool _overlayHeld = false;
+
+		uint32_t _stateFrames = 0;
+		uint32_t _steadyAllocations = 0;
+
 		bool _running = true;
 		bool _shadowAuto = false;
 		float _skew = 0.0;
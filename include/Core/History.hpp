@@ -0,0 +1,120 @@
+#ifndef SUPER_HAXAGON_HISTORY_HPP
+#define SUPER_HAXAGON_HISTORY_HPP
+
+#include "Core/Worker.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace SuperHaxagon {
+	class Game;
+	class Platform;
+
+	enum class RunEnd : uint8_t {
+		DIED,
+		BACK,
+		QUIT,
+		WON,
+	};
+
+	struct Run {
+		uint64_t level;
+		uint32_t seed;
+		float duration;
+		uint32_t deathFrame;
+		RunEnd cause;
+		float frameTime;
+	};
+
+	/**
+	 * Per level numbers computed from the history in a single pass.
+	 * Survival times go into a fixed histogram, so the memory used does
+	 * not depend on how many runs there are.
+	 */
+	struct RunStats {
+		static constexpr int BUCKETS = 120;
+		static constexpr float BUCKET_FRAMES = 300.0f;
+
+		uint32_t attempts = 0;
+		double total = 0;
+		float best = 0;
+		std::array<uint32_t, BUCKETS> histogram{};
+
+		void add(float duration);
+
+		/**
+		 * Average survival time in frames
+		 */
+		float getAverage() const;
+
+		/**
+		 * Survival time in frames that percent of the runs did not reach,
+		 * rounded up to the histogram's resolution
+		 */
+		float getPercentile(float percent) const;
+	};
+
+	/**
+	 * Every run of every level, appended to history.log.
+	 *
+	 * Runs are collected in memory and written as blocks of columns. When
+	 * the history opens, the worker reads the log once and builds the stats
+	 * of every level in it, so the game thread never waits on the disk.
+	 * Stats are kept up to date as runs are recorded, so the menu can ask
+	 * every frame.
+	 */
+	class History {
+	public:
+		static const char* BLOCK_HEADER;
+		static constexpr uint32_t BLOCK_RUNS = 32;
+
+		// Bytes per run, with the columns in the order they are stored
+		static constexpr size_t RUN_SIZE = sizeof(uint64_t) + sizeof(float) + sizeof(uint32_t) + sizeof(uint32_t) + sizeof(float) + sizeof(uint8_t);
+
+		explicit History(Game& game);
+		History(History&) = delete;
+		~History();
+
+		/**
+		 * Adds a finished run to the history
+		 */
+		void record(const Run& run);
+
+		/**
+		 * Gets the stats of a level. Empty until the worker has read the log.
+		 */
+		const RunStats& getStats(uint64_t id);
+
+		/**
+		 * Writes any runs that have not been written yet
+		 */
+		void save();
+
+	private:
+		void scan();
+		bool adopt();
+
+		Platform& _platform;
+		std::string _path;
+
+		std::vector<Run> _pending;
+		std::unordered_map<uint64_t, RunStats> _cache;
+
+		// Filled in by the worker, then taken over on the game thread once ready is set
+		std::unordered_map<uint64_t, RunStats> _scanned;
+		std::atomic<bool> _ready{false};
+		bool _adopted = false;
+
+		// Runs recorded before the scan was taken over, which it never saw
+		std::vector<Run> _early;
+
+		// Destroyed first so queued writes finish while everything else is alive
+		Worker _worker;
+	};
+}
+
+#endif //SUPER_HAXAGON_HISTORY_HPP
@@ -0,0 +1,93 @@
+#ifndef SUPER_HAXAGON_JOBS_HPP
+#define SUPER_HAXAGON_JOBS_HPP
+
+#include <cstddef>
+#include <functional>
+
+#ifndef SUPER_HAXAGON_NO_THREADS
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#endif
+
+namespace SuperHaxagon {
+	/**
+	 * Splits work that can be done in any order across every core, for
+	 * things that have to be finished before the caller can go on, like
+	 * the geometry of a frame or the packs that are being loaded. Unlike
+	 * Worker, the caller waits and helps out.
+	 *
+	 * Each thread has a queue of its own that work is dealt out to. A
+	 * thread takes from the back of its own, and once that is empty takes
+	 * from the front of someone else's, so a slow chunk never leaves the
+	 * other threads idle. The queues are rings that only grow when a batch
+	 * is split finer than any before it, so once warmed up, dealing out
+	 * work does not allocate.
+	 *
+	 * With one thread, or on platforms built with SUPER_HAXAGON_NO_THREADS,
+	 * the work is run straight through on the calling thread.
+	 */
+	class Jobs {
+	public:
+		using Body = std::function<void(size_t begin, size_t end)>;
+
+		/**
+		 * Threads counts the caller, so one starts no threads at all
+		 */
+		explicit Jobs(size_t threads);
+		Jobs(Jobs&) = delete;
+		~Jobs();
+
+		/**
+		 * Calls body over [0, count) in chunks of at most grain, from any
+		 * thread, and returns once every chunk is done. Bodies must not
+		 * call back into the same Jobs.
+		 */
+		void parallelFor(size_t count, size_t grain, const Body& body);
+
+		size_t getThreads() const;
+
+	private:
+#ifndef SUPER_HAXAGON_NO_THREADS
+		struct Batch;
+
+		struct Task {
+			Batch* batch;
+			size_t begin;
+			size_t end;
+		};
+
+		// A ring of tasks, only touched with the mutex held
+		struct Queue {
+			static constexpr size_t CAPACITY = 64; // To start with, a power of two
+
+			std::mutex mutex;
+			std::vector<Task> tasks = std::vector<Task>(CAPACITY);
+			size_t first = 0;
+			size_t size = 0;
+
+			void pushBack(const Task& task);
+			Task popBack();
+			Task popFront();
+		};
+
+		bool take(size_t queue, Task& task);
+		void runTask(const Task& task);
+		void run(size_t queue);
+
+		// One queue per thread, the last is for whoever calls parallelFor
+		std::vector<std::unique_ptr<Queue>> _queues;
+		std::vector<std::thread> _threads;
+
+		std::atomic<size_t> _queued{0}; // Tasks still sitting in a queue
+		bool _quit = false;
+		std::mutex _sleep;
+		std::condition_variable _wake; // New tasks, a batch finishing, or quitting
+#endif
+	};
+}
+
+#endif //SUPER_HAXAGON_JOBS_HPP
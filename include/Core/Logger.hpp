@@ -0,0 +1,95 @@
+#ifndef SUPER_HAXAGON_LOGGER_HPP
+#define SUPER_HAXAGON_LOGGER_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#ifndef SUPER_HAXAGON_NO_THREADS
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+
+namespace SuperHaxagon {
+	class Platform;
+	enum class Dbg;
+
+	/**
+	 * Takes messages off the hands of whoever logs them, so writing to a
+	 * console or a file never holds up a frame.
+	 *
+	 * Messages under the level are thrown away before anything is copied.
+	 * The rest go into a fixed ring that any thread can push to without
+	 * taking a lock, and a thread of its own hands them to the platform to
+	 * write out. When the ring is full, new messages are dropped and
+	 * counted rather than waited on. Fatal messages skip the line: the
+	 * ring is written out first, then the fatal one, before returning.
+	 *
+	 * Until start(), after stop(), and on platforms built with
+	 * SUPER_HAXAGON_NO_THREADS, messages are written out straight away.
+	 */
+	class Logger {
+	public:
+		static constexpr size_t ENTRIES = 128; // A power of two
+		static constexpr size_t WHERE = 16;
+		static constexpr size_t TEXT = 240;    // Longer messages are cut short
+
+		explicit Logger(Platform& platform);
+		Logger(Logger&) = delete;
+		~Logger();
+
+		/**
+		 * Starts the thread that writes messages out. The platform has to
+		 * be fully built by then.
+		 */
+		void start();
+
+		/**
+		 * Writes out whatever is left and stops the thread. Call it before
+		 * the platform is torn down or looks back over what it was sent.
+		 */
+		void stop();
+
+		void log(Dbg level, const std::string& where, const std::string& message);
+
+		/**
+		 * Whether a message at the level would be kept, so callers can
+		 * skip building one that would only be thrown away
+		 */
+		bool isLogged(Dbg level) const {return static_cast<int>(level) >= _level.load(std::memory_order_relaxed);}
+
+		void setLevel(Dbg level);
+		uint32_t getDropped() const {return _dropped.load(std::memory_order_relaxed);}
+
+	private:
+		struct Entry;
+
+		void write(Dbg level, const std::string& where, const std::string& message);
+
+		Platform& _platform;
+		std::atomic<int> _level;
+		std::atomic<uint32_t> _dropped{0};
+
+#ifndef SUPER_HAXAGON_NO_THREADS
+		bool push(Dbg level, const std::string& where, const std::string& message);
+		void drain();
+		void run();
+
+		std::unique_ptr<Entry[]> _entries;
+		std::atomic<size_t> _head{0}; // Next to be claimed by a producer
+		size_t _tail = 0;             // Next to be written out, only touched with _output held
+		uint32_t _reported = 0;       // Drops already written out, same
+
+		std::atomic<bool> _running{false};
+		std::mutex _output;           // Whoever holds it is the only one writing out
+		std::mutex _sleep;
+		std::condition_variable _wake;
+		std::thread _thread;
+#endif
+	};
+}
+
+#endif //SUPER_HAXAGON_LOGGER_HPP
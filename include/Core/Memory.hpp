@@ -0,0 +1,117 @@
+#ifndef SUPER_HAXAGON_MEMORY_HPP
+#define SUPER_HAXAGON_MEMORY_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace SuperHaxagon {
+	class Memory;
+	class Platform;
+
+	enum class MemoryTag : uint8_t {
+		LEVELS,   // Level factories, with their colors and names
+		PATTERNS, // Pattern factories and their walls
+		AUDIO,    // Decoded or buffered audio held by loaders
+		FONTS,    // Glyph atlases the game owns, not ones a library keeps
+		RUNTIME,  // Patterns live in the level being played
+		COUNT
+	};
+
+	/**
+	 * Bytes held against a tag for as long as this is alive. It can be
+	 * moved to whatever ends up owning the memory.
+	 */
+	class MemoryCharge {
+	public:
+		MemoryCharge() = default;
+		MemoryCharge(MemoryCharge&) = delete;
+		MemoryCharge(MemoryCharge&& other) noexcept;
+		MemoryCharge& operator=(MemoryCharge&& other) noexcept;
+		~MemoryCharge();
+
+		/**
+		 * Changes how much is held. Never refused, so only for memory
+		 * that is already in use.
+		 */
+		void resize(size_t bytes);
+
+		size_t getBytes() const {return _bytes;}
+
+		/**
+		 * False if nothing was charged, such as when a budget refused it
+		 */
+		explicit operator bool() const {return _memory != nullptr;}
+
+	private:
+		friend class Memory;
+		MemoryCharge(Memory& memory, MemoryTag tag, size_t bytes);
+
+		void release();
+
+		Memory* _memory = nullptr;
+		MemoryTag _tag = MemoryTag::LEVELS;
+		size_t _bytes = 0;
+	};
+
+	/**
+	 * Keeps track of how much memory each kind of data holds, and the most
+	 * it has ever held, so running out on small devices can be explained.
+	 *
+	 * A tag can have a budget. Anything that can be turned down, like a
+	 * custom level pack, asks with reserve() before it allocates, and is
+	 * refused with a message if it would go over. Charges can be taken and
+	 * dropped from any thread.
+	 */
+	class Memory {
+	public:
+		static constexpr size_t TAGS = static_cast<size_t>(MemoryTag::COUNT);
+		static constexpr size_t UNLIMITED = 0;
+
+		explicit Memory(Platform& platform);
+		Memory(Memory&) = delete;
+
+		/**
+		 * Charges bytes to a tag, or returns an empty charge and says why if
+		 * that would go over its budget. What is used in the message.
+		 */
+		MemoryCharge reserve(MemoryTag tag, size_t bytes, const std::string& what);
+
+		/**
+		 * Charges bytes to a tag whatever the budget, for memory the game
+		 * cannot go without
+		 */
+		MemoryCharge charge(MemoryTag tag, size_t bytes);
+
+		/**
+		 * Set before anything is loaded. UNLIMITED turns the budget off.
+		 */
+		void setBudget(MemoryTag tag, size_t bytes) {_budgets[static_cast<size_t>(tag)] = bytes;}
+
+		size_t getBudget(MemoryTag tag) const {return _budgets[static_cast<size_t>(tag)];}
+		size_t getCurrent(MemoryTag tag) const {return _current[static_cast<size_t>(tag)].load(std::memory_order_relaxed);}
+		size_t getPeak(MemoryTag tag) const {return _peak[static_cast<size_t>(tag)].load(std::memory_order_relaxed);}
+
+		/**
+		 * Logs the current and peak usage of every tag
+		 */
+		void report() const;
+
+		static const char* getName(MemoryTag tag);
+
+	private:
+		friend class MemoryCharge;
+
+		void add(MemoryTag tag, size_t bytes);
+		void remove(MemoryTag tag, size_t bytes);
+
+		Platform& _platform;
+		std::array<size_t, TAGS> _budgets{};
+		std::array<std::atomic<size_t>, TAGS> _current{};
+		std::array<std::atomic<size_t>, TAGS> _peak{};
+	};
+}
+
+#endif //SUPER_HAXAGON_MEMORY_HPP
@@ -0,0 +1,50 @@
+#ifndef SUPER_HAXAGON_MESSAGE_HISTORY_HPP
+#define SUPER_HAXAGON_MESSAGE_HISTORY_HPP
+
+#include "Logger.hpp"
+
+#include <array>
+#include <cstddef>
+#include <string>
+
+namespace SuperHaxagon {
+	/**
+	 * The last few messages a platform wrote out, for it to look back over
+	 * when showing a fatal error. Like the logger's ring it is fixed in
+	 * size, so once full the oldest message makes way for the newest and
+	 * nothing is allocated.
+	 */
+	class MessageHistory {
+	public:
+		static constexpr size_t MESSAGES = 32;
+		static constexpr size_t LENGTH = 16 + Logger::WHERE + Logger::TEXT; // Room for a tag like "[3ds:info] "
+
+		MessageHistory() = default;
+		MessageHistory(MessageHistory&) = delete;
+
+		/**
+		 * Formats the message behind the tag and keeps it, returning the
+		 * line so the platform can also write it out
+		 */
+		const char* add(Dbg level, const char* tag, const std::string& where, const std::string& message);
+
+		bool hasFatal() const;
+
+		size_t size() const {return _count;}
+
+		// Oldest first
+		const char* get(size_t i) const;
+
+	private:
+		struct Entry {
+			Dbg level;
+			char text[LENGTH];
+		};
+
+		std::array<Entry, MESSAGES> _entries{};
+		size_t _next = 0;
+		size_t _count = 0;
+	};
+}
+
+#endif //SUPER_HAXAGON_MESSAGE_HISTORY_HPP
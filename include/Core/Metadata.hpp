@@ -1,27 +1,60 @@
 #ifndef SUPER_HAXAGON_METADATA_HPP
 #define SUPER_HAXAGON_METADATA_HPP
 
-#include <map>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
 
 namespace SuperHaxagon {
+	/**
+	 * The labels of a BGM compiled into one timeline sorted by time.
+	 *
+	 * Labels are interned into event bits once, so callers look up the bits
+	 * they care about up front and test a mask every frame instead of
+	 * comparing strings. Only the labels the game acts on have a bit, and
+	 * the table of them is fixed, so what is in a file can never take a
+	 * bit away from them. Any other label is dropped when the file is read.
+	 */
 	class Metadata {
 	public:
+		static constexpr int MAX_EVENTS = 64;
+
+		// Jumping back further than this is treated as a loop or a seek
+		static constexpr float RESYNC_TIME = 10.0f;
+
 		explicit Metadata(std::unique_ptr<std::istream> stream);
+		Metadata(const Metadata&) = default;
 		~Metadata();
 		Metadata& operator=(const Metadata&) = delete;
-		
-		bool getMetadata(float time, const std::string& label);
 
-		float getMaxTime();
+		/**
+		 * Gets the bit that advance() sets for a label. Returns 0 for a
+		 * label the game does not act on, so it never fires.
+		 */
+		static uint64_t getEvent(const std::string& label);
+
+		/**
+		 * Moves the timeline to time and returns the bits of every event
+		 * in (previous time, time]. A large jump backwards re-syncs
+		 * without firing anything.
+		 */
+		uint64_t advance(float time);
+
+		float getMaxTime() const;
+
+		size_t getSize() const {return sizeof(Metadata) + _timeline.capacity() * sizeof(Event);}
 
 	private:
-		float _time = 0;
-		std::map<std::string, std::vector<float>> _timestamps;
-		std::map<std::string, size_t> _indices;
+		struct Event {
+			float time;
+			uint64_t bit;
+		};
+
+		std::vector<Event> _timeline;
+		size_t _cursor = 0;
+		float _time = -1.0f;
 	};
 }
 
-#endif //SUPER_HAXAGON_METADATA_HPP
\ No newline at end of file
+#endif //SUPER_HAXAGON_METADATA_HPP
@@ -0,0 +1,99 @@
+#ifndef SUPER_HAXAGON_METRICS_HPP
+#define SUPER_HAXAGON_METRICS_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+
+namespace SuperHaxagon {
+	/**
+	 * Counts how many observations fell at or under each bound, in seconds.
+	 * Only one thread may observe, but any thread can write it out.
+	 */
+	class Histogram {
+	public:
+		static constexpr size_t BUCKETS = 8;
+
+		explicit Histogram(const std::array<float, BUCKETS>& bounds);
+		Histogram(Histogram&) = delete;
+
+		void observe(float seconds);
+
+		/**
+		 * Writes it out in the Prometheus text format
+		 */
+		void write(std::ostream& stream, const char* name, const char* help) const;
+
+	private:
+		std::array<float, BUCKETS> _bounds;
+		std::array<std::atomic<uint32_t>, BUCKETS + 1> _counts{}; // The last is over every bound
+		std::atomic<uint64_t> _micros{0};
+	};
+
+	/**
+	 * Health numbers that are always kept, even in release builds, so a
+	 * machine out in the field can be scraped while it runs. Each value
+	 * has a single thread writing it, so updating one is a relaxed load
+	 * and store, and the game never waits on whoever is reading them.
+	 */
+	class Metrics {
+	public:
+		// Stepping more than this many 60 FPS frames at once is a spike
+		static constexpr float DILATION_SPIKE = 2.0f;
+		static constexpr float BUDGET_SECONDS = 1.0f / 60.0f;
+
+		Metrics();
+		Metrics(Metrics&) = delete;
+
+		/**
+		 * Game thread, once a frame
+		 */
+		void frame(float dilation);
+
+		/**
+		 * Game thread, whenever a level is started
+		 */
+		void levelPlayed();
+
+		/**
+		 * Game thread, with the running total from the audio side
+		 */
+		void setUnderruns(uint32_t underruns);
+
+		/**
+		 * Observed on the game thread, as levels are loaded when it starts
+		 */
+		Histogram& getLevelLoads() {return _levelLoads;}
+
+		/**
+		 * Observed on the worker, which does all BGM loading
+		 */
+		Histogram& getBGMLoads() {return _bgmLoads;}
+
+		/**
+		 * Observed on the game thread, by platforms that know when a frame
+		 * was presented
+		 */
+		Histogram& getInputLatency() {return _inputLatency;}
+
+		/**
+		 * Writes every metric out in the Prometheus text format
+		 */
+		void write(std::ostream& stream) const;
+
+	private:
+		std::chrono::steady_clock::time_point _last{}; // Game thread only
+		Histogram _frames;
+		Histogram _levelLoads;
+		Histogram _bgmLoads;
+		Histogram _inputLatency;
+		std::atomic<uint64_t> _dropped{0};
+		std::atomic<uint64_t> _spikes{0};
+		std::atomic<uint64_t> _levels{0};
+		std::atomic<uint32_t> _underruns{0};
+	};
+}
+
+#endif //SUPER_HAXAGON_METRICS_HPP
@@ -0,0 +1,205 @@
+#ifndef SUPER_HAXAGON_MIXER_HPP
+#define SUPER_HAXAGON_MIXER_HPP
+
+#include "Core/MusicClock.hpp"
+#include "Core/RingBuffer.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#ifndef SUPER_HAXAGON_NO_THREADS
+#include <thread>
+#endif
+
+namespace SuperHaxagon {
+	class OggStream;
+	class Trace;
+	struct Sound;
+
+	/**
+	 * Mixes a fixed set of voices into 16 bit stereo for platforms that
+	 * only give us a raw audio device.
+	 *
+	 * The game thread starts and stops voices, pump() renders ahead into
+	 * a ring buffer, and the device callback takes finished audio out of it
+	 * with pull(). Nothing on the way allocates, and sounds and streams a
+	 * voice is done with are handed back to the game to free. Only pump()
+	 * can wait, on the trace's lock while one is recording, and pull()
+	 * never does.
+	 * With threads, the mixer pumps itself; otherwise the platform calls
+	 * pump() once per frame.
+	 *
+	 * Voices are handed out as handles that also count how many times the
+	 * voice has been started, so a handle kept after its sound finished
+	 * does nothing once the voice goes to another sound.
+	 */
+	class Mixer {
+	public:
+		static constexpr int VOICES = 16;
+		static constexpr int CHANNELS = 2;
+		static constexpr size_t BLOCK_FRAMES = 256;
+
+		// Highest source rate a voice can have, as a multiple of the mixer's
+		static constexpr int MAX_STEP = 4;
+
+		Mixer(int rate, size_t latencyFrames);
+		Mixer(Mixer&) = delete;
+		~Mixer();
+
+		/**
+		 * Starts a sound on a free voice. Returns a handle to the voice,
+		 * or -1 if they are all busy.
+		 */
+		int play(std::shared_ptr<const Sound> sound, bool loop, float gain = 1.0f);
+
+		/**
+		 * Starts a stream on a free voice. The voice ends when the stream is done.
+		 */
+		int play(std::shared_ptr<OggStream> stream, float gain = 1.0f);
+
+		// The rest take a handle from play(), and do nothing once the voice has moved on
+		void stop(int handle);
+		void setPaused(int handle, bool paused);
+		void setGain(int handle, float gain);
+
+		/**
+		 * A voice stays playing until it is stopped or a sound that does not loop ends
+		 */
+		bool isPlaying(int handle) const;
+
+		/**
+		 * Position of a voice in seconds as it is heard, published by pull()
+		 */
+		float getTime(int handle) const;
+
+		/**
+		 * Producer side. Renders blocks until the ring is full.
+		 */
+		void pump();
+
+		/**
+		 * Game side. Frees the sounds and streams of voices that have
+		 * finished, which can mean waiting on a stream's decoder. Done
+		 * whenever a voice starts, but the platform can call it sooner.
+		 */
+		void collect();
+
+		/**
+		 * Consumer side, for the device. Always fills frames, with silence
+		 * if the ring ran dry, and returns how many frames were real audio.
+		 * The device is assumed to play these once it is done with the
+		 * last frames it pulled.
+		 */
+		size_t pull(int16_t* out, size_t frames);
+
+		int getRate() const {return _rate;}
+		size_t getQueued() const {return _output.getAvailable() / CHANNELS;}
+		size_t getCapacity() const {return _output.getCapacity() / CHANNELS;}
+		uint32_t getUnderruns() const {return _underruns.load(std::memory_order_relaxed);}
+
+		/**
+		 * Recent time spent rendering divided by the length of audio rendered.
+		 * Only measured when the mixer runs its own thread.
+		 */
+		float getLoad() const {return _load.load(std::memory_order_relaxed);}
+
+		/**
+		 * Records each pump and any underruns it finds on the audio track.
+		 * Set it before anything plays.
+		 */
+		void setTrace(Trace* trace) {_trace = trace;}
+
+	private:
+		enum class Command : uint8_t {
+			PLAY,
+			STOP,
+			PAUSE,
+			RESUME,
+			GAIN,
+		};
+
+		struct Message {
+			Command command;
+			int voice;
+			std::shared_ptr<const Sound> sound;
+			std::shared_ptr<OggStream> stream;
+			bool loop;
+			float gain;
+		};
+
+		// Only touched by the thread that renders
+		struct Voice {
+			std::shared_ptr<const Sound> sound;
+			std::shared_ptr<OggStream> stream;
+			uint64_t position = 0;
+			uint64_t step = 0;
+			float gain = 1.0f;
+			bool loop = false;
+			bool paused = false;
+
+			// Streams and compressed sounds are staged a block at a time,
+			// keeping one frame back to interpolate towards. Sized once for
+			// the largest of either, so playing never allocates.
+			std::vector<int16_t> stage;
+			size_t staged = 0;
+
+			// The next compressed block, and how far into the sound the stage reaches
+			size_t block = 0;
+			uint64_t source = 0;
+		};
+
+		// Where every voice was at the start of a rendered block, for pull() to publish
+		struct Mark {
+			std::array<float, VOICES> times{};
+			uint32_t running = 0; // One bit per voice
+		};
+
+		int start(Message message, int rate);
+		void send(Command command, int handle, float gain = 0.0f);
+		void receive();
+		void render(int16_t* out, size_t frames);
+		bool mix(Voice& voice, float* accum, size_t frames) const;
+		bool mixStaged(Voice& voice, float* accum, size_t frames) const;
+		size_t decode(Voice& voice) const;
+		float getPosition(const Voice& voice, int index) const;
+		void publish(uint32_t first, size_t frames);
+		void finish(int voice);
+		int getSlot(int handle) const;
+
+		const int _rate;
+		RingBuffer<Message> _messages;
+		RingBuffer<Message> _finished; // Back from the renderer, to be freed by the game
+		RingBuffer<int16_t> _output;
+
+		std::array<Voice, VOICES> _voices{};
+		std::vector<float> _accum;
+		std::vector<int16_t> _block;
+
+		// Shared between the game and the renderer
+		std::array<std::atomic<bool>, VOICES> _busy{};
+		std::array<int, VOICES> _rates{};
+		std::array<uint32_t, VOICES> _generations{}; // Game only
+
+		// Written by the renderer ahead of the blocks, read by the device behind them
+		std::vector<Mark> _marks;
+		uint32_t _rendered = 0; // In blocks, renderer only
+		uint32_t _pulled = 0;   // In frames, device only
+		std::array<MusicClock, VOICES> _clocks;
+
+		std::atomic<uint32_t> _underruns{0};
+		std::atomic<float> _load{0};
+
+		Trace* _trace = nullptr;
+		uint32_t _traced = 0; // Underruns already in the trace, renderer only
+
+#ifndef SUPER_HAXAGON_NO_THREADS
+		std::atomic<bool> _running{true};
+		std::thread _thread;
+#endif
+	};
+}
+
+#endif //SUPER_HAXAGON_MIXER_HPP
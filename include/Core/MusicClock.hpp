@@ -0,0 +1,60 @@
+#ifndef SUPER_HAXAGON_MUSIC_CLOCK_HPP
+#define SUPER_HAXAGON_MUSIC_CLOCK_HPP
+
+#include <atomic>
+#include <cstdint>
+
+namespace SuperHaxagon {
+	/**
+	 * Where the music is, as heard, for the game thread.
+	 *
+	 * Whatever feeds the audio output publishes the song position of the
+	 * sample going out and when that was. The game thread reads the last
+	 * published position and adds the time since, so it moves smoothly
+	 * between updates however rarely the audio side gets to publish.
+	 *
+	 * There must only be one publisher. Publishing and reading never block.
+	 */
+	class MusicClock {
+	public:
+		// Past this, the audio side has stalled and the clock stops with it
+		static constexpr float MAX_EXTRAPOLATION = 0.1f;
+
+		MusicClock();
+		MusicClock(MusicClock&) = delete;
+
+		/**
+		 * Publisher only. Position of the sample being heard right now, in
+		 * seconds, and whether it is moving.
+		 */
+		void publish(float position, bool running);
+
+		/**
+		 * Reader only. Never goes backwards by less than MAX_EXTRAPOLATION,
+		 * so small corrections do not make effects fire twice. Bigger jumps
+		 * (loops, seeks) come through as they are.
+		 */
+		float getTime() const;
+
+		/**
+		 * Reader only. Forgets the last time handed out, for a new song.
+		 */
+		void restart() const {_last = 0.0f;}
+
+		/**
+		 * Microseconds since an arbitrary point, the same one for every clock
+		 */
+		static uint32_t now();
+
+	private:
+		// A sequence lock: odd while the publisher is halfway through
+		std::atomic<uint32_t> _sequence{0};
+		std::atomic<float> _position{0.0f};
+		std::atomic<uint32_t> _stamp{0};
+		std::atomic<bool> _running{false};
+
+		mutable float _last = 0.0f;
+	};
+}
+
+#endif //SUPER_HAXAGON_MUSIC_CLOCK_HPP
@@ -0,0 +1,96 @@
+#ifndef SUPER_HAXAGON_OGG_STREAM_HPP
+#define SUPER_HAXAGON_OGG_STREAM_HPP
+
+#include "Core/RingBuffer.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#ifndef SUPER_HAXAGON_NO_THREADS
+#include <thread>
+#endif
+
+struct stb_vorbis;
+
+namespace SuperHaxagon {
+	/**
+	 * Decodes an OGG file ahead of playback into a bounded ring of 16 bit
+	 * interleaved PCM, for platforms that have to feed BGM themselves.
+	 *
+	 * With threads, decoding runs on a background thread that keeps the
+	 * ring topped up. Without them, whoever plays the stream calls pump().
+	 *
+	 * Looping jumps straight from the loop end to the loop start inside the
+	 * decoder, so there is no gap. Loop points come from the LOOPSTART and
+	 * LOOPLENGTH (or LOOPEND) comments if the file has them, and cover the
+	 * whole song otherwise.
+	 */
+	class OggStream {
+	public:
+		static constexpr int CHUNK_FRAMES = 1024;
+		static constexpr int DEFAULT_LATENCY_MS = 200;
+
+		explicit OggStream(const std::string& path, int latencyMs = DEFAULT_LATENCY_MS);
+		OggStream(OggStream&) = delete;
+		~OggStream();
+
+		bool isOpen() const {return _vorbis != nullptr;}
+		int getRate() const {return _rate;}
+		int getChannels() const {return _channels;}
+
+		void setLoop(bool loop);
+
+		/**
+		 * Producer side. Decodes until the ring is full or the song ends.
+		 */
+		void pump();
+
+		/**
+		 * Consumer side. Copies up to frames frames of audio into out and
+		 * returns how many there were. Coming up short before the end of
+		 * the song counts as an underrun.
+		 */
+		size_t read(int16_t* out, size_t frames);
+
+		/**
+		 * True once the song ended without looping and everything was read
+		 */
+		bool isDone() const;
+
+		/**
+		 * Position in the song of the last frame read, in seconds
+		 */
+		float getTime() const;
+
+		uint32_t getUnderruns() const {return _underruns.load(std::memory_order_relaxed);}
+		uint32_t getLoops() const;
+
+	private:
+		uint32_t getComment(const char* key, uint32_t fallback) const;
+
+		stb_vorbis* _vorbis = nullptr;
+		int _rate = 0;
+		int _channels = 0;
+		uint32_t _loopStart = 0;
+		uint32_t _loopEnd = 0;
+
+		// Decoder side
+		uint32_t _cursor = 0;
+		std::vector<int16_t> _chunk;
+
+		RingBuffer<int16_t> _ring;
+		std::atomic<bool> _loop{false};
+		std::atomic<bool> _finished{false};
+		std::atomic<uint32_t> _consumed{0};
+		std::atomic<uint32_t> _underruns{0};
+
+#ifndef SUPER_HAXAGON_NO_THREADS
+		std::atomic<bool> _running{true};
+		std::thread _thread;
+#endif
+	};
+}
+
+#endif //SUPER_HAXAGON_OGG_STREAM_HPP
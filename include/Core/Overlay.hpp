@@ -0,0 +1,40 @@
+#ifndef SUPER_HAXAGON_OVERLAY_HPP
+#define SUPER_HAXAGON_OVERLAY_HPP
+
+#include <cstddef>
+
+namespace SuperHaxagon {
+	class Game;
+	class Level;
+
+	/**
+	 * Performance numbers for testers, drawn over the bottom screen.
+	 *
+	 * Shows a graph of recent frame times against the 60 FPS budget, the
+	 * median and 99th percentile frame time, how many polygons and vertices
+	 * the last frame drew, how many patterns and walls the level has live,
+	 * and how full the audio output is. The timings come from the profiler,
+	 * so builds without it show an empty graph.
+	 *
+	 * The profiler's trace records for as long as the overlay is up, and
+	 * is written to trace.json in the user directory when it is closed.
+	 */
+	class Overlay {
+	public:
+		static constexpr size_t GRAPH_FRAMES = 60;
+
+		explicit Overlay(Game& game);
+		Overlay(Overlay&) = delete;
+
+		/**
+		 * Draws the overlay in the bottom left corner. The level can be
+		 * nullptr if the current state does not have one.
+		 */
+		void draw(float scale, const Level* level) const;
+
+	private:
+		Game& _game;
+	};
+}
+
+#endif //SUPER_HAXAGON_OVERLAY_HPP
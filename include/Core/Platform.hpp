@@ -3,6 +3,10 @@
 
 #include "AudioLoader.hpp"
 #include "AudioPlayer.hpp"
+#include "Logger.hpp"
+#include "Memory.hpp"
+#include "Metrics.hpp"
+#include "Profiler.hpp"
 
 #include <memory>
 #include <string>
@@ -26,6 +30,13 @@ namespace SuperHaxagon {
 		bool quit : 1;
 		bool left : 1;
 		bool right : 1;
+		bool overlay : 1;
+	};
+
+	// How much of a frame, from 0 to 1, the cursor was held each way
+	struct Held {
+		float left;
+		float right;
 	};
 
 	enum class Supports {
@@ -52,7 +63,7 @@ namespace SuperHaxagon {
 
 	class Platform {
 	public:
-		explicit Platform(const Dbg dbg) : _dbg(dbg) {}
+		explicit Platform(const Dbg dbg) : _dbg(dbg), _logger(*this), _profiler(*this), _memory(*this) {}
 		Platform(Platform&) = delete;
 		virtual ~Platform() = default;
 
@@ -65,12 +76,52 @@ namespace SuperHaxagon {
 		virtual std::unique_ptr<Font> loadFont(const std::string& partial, int size) = 0;
 
 		virtual void playSFX(AudioLoader& audio) = 0;
-		virtual void playBGM(AudioLoader& audio) = 0;
 		virtual void stopBGM();
+
+		/**
+		 * Starts a looping BGM player in place of the current one. The old
+		 * player is handed back so it can be faded out, unless the platform
+		 * can only play one BGM at a time, in which case it is already gone.
+		 */
+		virtual std::unique_ptr<AudioPlayer> swapBGM(std::unique_ptr<AudioPlayer> bgm);
 		virtual AudioPlayer* getBGM();
 
+		/**
+		 * How full the audio output is, from 0 to 1, or below 0 if the
+		 * platform leaves that to a library that does not say
+		 */
+		virtual float getAudioFill() const;
+
+		/**
+		 * How many times the audio output has run dry, or 0 if the
+		 * platform leaves that to a library that does not say
+		 */
+		virtual uint32_t getAudioUnderruns() const;
+
+		/**
+		 * How many threads the game can keep busy at once, counting
+		 * its own
+		 */
+		virtual size_t getCores() const;
+
 		virtual std::string getButtonName(const Buttons& button) = 0;
 		virtual Buttons getPressed() = 0;
+
+		/**
+		 * How much of the time since it was last asked left and right were
+		 * held, so a tap shorter than a frame moves the cursor by less than
+		 * a frame's step. Left wins while both are down. By default
+		 * whatever getPressed() says now counts for the whole frame.
+		 */
+		virtual Held getHeld();
+
+		/**
+		 * Set while a state that asks for getHeld() is running, for
+		 * platforms that watch input closely only while it is needed.
+		 * Does nothing by default.
+		 */
+		virtual void setSampling(bool sampling);
+
 		virtual Point getScreenDim() const = 0;
 
 		virtual void screenBegin() = 0;
@@ -78,14 +129,62 @@ namespace SuperHaxagon {
 		virtual void screenFinalize() = 0;
 		virtual void drawPoly(const Color& color, const std::vector<Point>& points) = 0;
 
+		/**
+		 * The most antialiasing samples the platform draws with, or 0 if
+		 * it does not let the game choose
+		 */
+		virtual unsigned getMaxSamples() const;
+
+		/**
+		 * Draws with this many antialiasing samples from the next frame.
+		 * Can be slow, as the window may have to be made again, so the
+		 * game only calls it between states.
+		 */
+		virtual void setSamples(unsigned samples);
+
 		virtual std::unique_ptr<Twist> getTwister() = 0;
 
 		virtual void shutdown() = 0;
-		virtual void message(Dbg level, const std::string& where, const std::string& message) = 0;
 		virtual Supports supports();
 
+		/**
+		 * Logs a message from any thread. See Logger for when it is written out.
+		 */
+		void message(Dbg level, const std::string& where, const std::string& message);
+
+		/**
+		 * Check before formatting a message, so nothing is built for one
+		 * under the level
+		 */
+		bool isLogged(const Dbg level) const {return _logger.isLogged(level);}
+
+		Logger& getLogger() {return _logger;}
+
+		Profiler& getProfiler() {return _profiler;}
+		Metrics& getMetrics() {return _metrics;}
+		Memory& getMemory() {return _memory;}
+
+		/**
+		 * Set while the performance overlay is up, for platforms that
+		 * have somewhere else to put it
+		 */
+		void setOverlay(const bool overlay) {_overlay = overlay;}
+
 	protected:
+		friend class Logger;
+
+		/**
+		 * Writes a message out. Called by the logger, one message at a
+		 * time, but not always from the same thread.
+		 */
+		virtual void output(Dbg level, const std::string& where, const std::string& message) = 0;
+
 		Dbg _dbg;
+		Logger _logger;
+		Profiler _profiler;
+		Metrics _metrics;
+		Memory _memory;
+		bool _overlay = false;
 		std::unique_ptr<AudioPlayer> _bgm{};
 	};
 }
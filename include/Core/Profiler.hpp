@@ -0,0 +1,154 @@
+#ifndef SUPER_HAXAGON_PROFILER_HPP
+#define SUPER_HAXAGON_PROFILER_HPP
+
+#include "Core/Allocations.hpp"
+#include "Core/Trace.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+// Zones cost a couple of clock reads each, so they are only built in when
+// SUPER_HAXAGON_PROFILE is set, or when allocations are being tracked, which
+// are counted through them
+#if defined(SUPER_HAXAGON_ALLOC_TRACK) && !defined(SUPER_HAXAGON_PROFILE)
+#define SUPER_HAXAGON_PROFILE
+#endif
+
+#ifdef SUPER_HAXAGON_PROFILE
+#define SUPER_HAXAGON_ZONE(profiler, zone) SuperHaxagon::ProfileZone profileZone((profiler), (zone))
+#define SUPER_HAXAGON_POLY(profiler, vertices) SUPER_HAXAGON_ZONE(profiler, SuperHaxagon::Zone::DRAW_POLY); (profiler).addVertices(vertices)
+#define SUPER_HAXAGON_FRAME(profiler) (profiler).frame()
+#define SUPER_HAXAGON_SPAN(trace, track, name, detail) SuperHaxagon::TraceSpan traceSpan((trace), (track), (name), (detail))
+#define SUPER_HAXAGON_INSTANT(trace, track, name, detail) (trace).instant((track), (name), (detail))
+#else
+#define SUPER_HAXAGON_ZONE(profiler, zone) ((void)0)
+#define SUPER_HAXAGON_POLY(profiler, vertices) ((void)0)
+#define SUPER_HAXAGON_FRAME(profiler) ((void)0)
+#define SUPER_HAXAGON_SPAN(trace, track, name, detail) static_cast<void>(trace)
+#define SUPER_HAXAGON_INSTANT(trace, track, name, detail) static_cast<void>(trace)
+#endif
+
+namespace SuperHaxagon {
+	class Platform;
+
+	enum class Zone : uint8_t {
+		UPDATE,
+		DRAW_TOP,
+		DRAW_BOT,
+		LEVEL_UPDATE,
+		LEVEL_COLLISION,
+		LEVEL_DRAW,
+		DRAW_POLY,
+		FINALIZE,
+		COUNT
+	};
+
+	/**
+	 * Times named zones of the game loop and adds them up per frame.
+	 *
+	 * Zones nest, and each one only counts the time not spent in the zones
+	 * inside it, so a slow frame can be put down to a single zone. Finished
+	 * frames go into a ring buffer, and a frame that ran long enough to
+	 * miss the next one is logged along with the zone that took longest.
+	 *
+	 * Only the game thread may use it. Use the macros, so builds without
+	 * SUPER_HAXAGON_PROFILE do not pay for it.
+	 */
+	class Profiler {
+	public:
+		static constexpr size_t ZONES = static_cast<size_t>(Zone::COUNT);
+		static constexpr size_t FRAMES = 128;
+		static constexpr size_t MAX_DEPTH = 8;
+
+		// The game was designed for 60 FPS. Frames that take this many
+		// frames worth of time have missed at least one vsync.
+		static constexpr float BUDGET_MS = 1000.0f / 60.0f;
+		static constexpr float HITCH = 1.5f;
+
+		struct Frame {
+			uint32_t number = 0;
+			float total = 0;                  // Milliseconds since the frame before
+			float busy = 0;                   // Milliseconds spent in any zone
+			std::array<float, ZONES> self{};  // Milliseconds in each zone, without the zones inside it
+			std::array<uint32_t, ZONES> calls{};
+			uint32_t vertices = 0;            // Handed to drawPoly, one call to it being one polygon
+			uint32_t allocs = 0;              // Heap allocations on the game thread, see Allocations
+			uint32_t allocBytes = 0;
+			std::array<uint32_t, ZONES> selfAllocs{};
+			std::array<uint32_t, ZONES> selfAllocBytes{};
+		};
+
+		explicit Profiler(Platform& platform);
+		Profiler(Profiler&) = delete;
+
+		void enter(Zone zone);
+		void leave();
+		void addVertices(const size_t vertices) {_current.vertices += static_cast<uint32_t>(vertices);}
+
+		/**
+		 * Closes the frame so far and starts the next one
+		 */
+		void frame();
+
+		/**
+		 * A finished frame, 0 being the last one. Returns nullptr past the
+		 * oldest frame still held.
+		 */
+		const Frame* getFrame(size_t ago) const;
+		uint32_t getHitches() const {return _hitches;}
+
+		/**
+		 * Zones other than drawPoly, and each whole frame, go into this
+		 * while it is recording
+		 */
+		Trace& getTrace() {return _trace;}
+
+		static const char* getName(Zone zone);
+
+		/**
+		 * Logs a frame that allocated, along with the zone that allocated
+		 * most. Call it between frames, so the log is not put on the next one.
+		 */
+		void reportAllocations(const Frame& frame);
+
+	private:
+		using Clock = std::chrono::steady_clock;
+
+		struct Open {
+			Zone zone;
+			Clock::time_point start;
+			float inner; // Milliseconds spent in zones inside this one
+			Allocations::Count allocated;
+			Allocations::Count innerAllocated;
+		};
+
+		void report(const Frame& frame) const;
+
+		Platform& _platform;
+		Trace _trace;
+
+		std::array<Frame, FRAMES> _frames{};
+		uint32_t _finished = 0;
+		uint32_t _hitches = 0;
+		Frame _current{};
+		Clock::time_point _start{};
+		Allocations::Count _startAllocated{0, 0};
+
+		// Zones too deep for the stack are not timed at all
+		std::array<Open, MAX_DEPTH> _open{};
+		size_t _depth = 0;
+	};
+
+	class ProfileZone {
+	public:
+		ProfileZone(Profiler& profiler, const Zone zone) : _profiler(profiler) {_profiler.enter(zone);}
+		ProfileZone(ProfileZone&) = delete;
+		~ProfileZone() {_profiler.leave();}
+
+	private:
+		Profiler& _profiler;
+	};
+}
+
+#endif //SUPER_HAXAGON_PROFILER_HPP
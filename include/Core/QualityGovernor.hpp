@@ -0,0 +1,91 @@
+#ifndef SUPER_HAXAGON_QUALITY_GOVERNOR_HPP
+#define SUPER_HAXAGON_QUALITY_GOVERNOR_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace SuperHaxagon {
+	class Platform;
+
+	// From best to worst, each giving up a little more than the last
+	enum class Quality {
+		FULL,
+		FEWER_SAMPLES,   // Half the antialiasing
+		NO_SAMPLES,      // No antialiasing
+		NO_SHADOWS,
+		FLAT_BACKGROUND, // One color instead of slices
+		PLAIN_TEXT,      // No panels behind text
+	};
+
+	/**
+	 * Steps drawing down when frames keep running over budget, and back up
+	 * when there is room again, so weak hardware holds its frame rate
+	 * instead of the game slowing down through dilation.
+	 *
+	 * It goes down once the frame time, averaged over a second or so, is
+	 * well over budget. It only goes back up once frames are on time and
+	 * the work in them leaves plenty spare, and it waits longer each time
+	 * going up did not last, so it does not flicker between two levels.
+	 * Steps the platform cannot do, such as antialiasing where it is not
+	 * set by the game, are skipped. Antialiasing can mean making the
+	 * window again, so a change to it waits for the next settle().
+	 */
+	class QualityGovernor {
+	public:
+		static constexpr float BUDGET = 1.0f / 60.0f;   // Seconds a frame, which the game was made for
+		static constexpr size_t WINDOW = 60;            // Frames the averages are taken over
+		static constexpr float OVER = 1.2f;             // Of the budget, frames averaged over this go down
+		static constexpr float ON_TIME = 1.05f;         // Of the budget, frames averaged under this are on time
+		static constexpr float HEADROOM = 0.5f;         // Of the budget, work averaged under this has room to go up
+		static constexpr uint32_t SETTLE_FRAMES = 60;   // Not judged after a change, as it can hitch
+		static constexpr uint32_t RAISE_FRAMES = 180;   // With room to spare before going up
+		static constexpr uint32_t MAX_RAISE_FRAMES = RAISE_FRAMES * 32;
+		static constexpr uint32_t FAILED_FRAMES = 600;  // Going down this soon after going up means it failed
+
+		explicit QualityGovernor(Platform& platform);
+		QualityGovernor(QualityGovernor&) = delete;
+
+		/**
+		 * Call once a frame. Interval is the seconds since the last frame,
+		 * work is the seconds spent on this one, not counting any waiting.
+		 */
+		void frame(float interval, float work);
+
+		/**
+		 * Call when something slow and one off is coming up, such as a
+		 * state change, so it does not count against the quality. Any
+		 * change to antialiasing is made here.
+		 */
+		void settle();
+
+		Quality getQuality() const {return _quality;}
+
+		bool hasShadows() const;
+		bool hasSlices() const {return _quality < Quality::FLAT_BACKGROUND;}
+		bool hasTextPanels() const {return _quality < Quality::PLAIN_TEXT;}
+
+	private:
+		bool applies(Quality quality) const;
+		unsigned getSamples() const;
+		void change(bool up, float interval, float work);
+		void restart();
+
+		Platform& _platform;
+		Quality _quality = Quality::FULL;
+		unsigned _samples = 0; // Antialiasing at full quality, 0 if the platform does not set it
+
+		std::array<float, WINDOW> _intervals{};
+		std::array<float, WINDOW> _work{};
+		size_t _filled = 0;
+		size_t _next = 0;
+
+		uint32_t _settle = 0;
+		uint32_t _spare = 0;
+		uint32_t _raiseFrames = RAISE_FRAMES;
+		uint32_t _sinceRaise = 0;
+		bool _raised = false;
+	};
+}
+
+#endif //SUPER_HAXAGON_QUALITY_GOVERNOR_HPP
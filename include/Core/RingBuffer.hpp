@@ -0,0 +1,82 @@
+#ifndef SUPER_HAXAGON_RING_BUFFER_HPP
+#define SUPER_HAXAGON_RING_BUFFER_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace SuperHaxagon {
+	/**
+	 * A fixed size queue between exactly one producer thread and one
+	 * consumer thread. Neither side ever blocks or takes a lock, so it is
+	 * safe to use from an audio device callback.
+	 */
+	template <typename T>
+	class RingBuffer {
+	public:
+		explicit RingBuffer(size_t capacity) {
+			// Power of two, so indices wrap with a mask
+			size_t size = 1;
+			while (size < capacity) size <<= 1;
+			_buffer.resize(size);
+			_mask = size - 1;
+		}
+
+		RingBuffer(RingBuffer&) = delete;
+
+		/**
+		 * Producer only. Copies as many items as fit and returns how many that was.
+		 */
+		size_t write(const T* data, const size_t count) {
+			const auto head = _head.load(std::memory_order_relaxed);
+			const auto tail = _tail.load(std::memory_order_acquire);
+			const auto amount = std::min(count, _buffer.size() - (head - tail));
+			for (size_t i = 0; i < amount; i++) _buffer[(head + i) & _mask] = data[i];
+			_head.store(head + amount, std::memory_order_release);
+			return amount;
+		}
+
+		/**
+		 * Consumer only. Moves up to count items out and returns how many that was.
+		 */
+		size_t read(T* out, const size_t count) {
+			const auto tail = _tail.load(std::memory_order_relaxed);
+			const auto head = _head.load(std::memory_order_acquire);
+			const auto amount = std::min(count, head - tail);
+			for (size_t i = 0; i < amount; i++) out[i] = std::move(_buffer[(tail + i) & _mask]);
+			_tail.store(tail + amount, std::memory_order_release);
+			return amount;
+		}
+
+		bool push(const T& item) {
+			return write(&item, 1) == 1;
+		}
+
+		bool pop(T& item) {
+			return read(&item, 1) == 1;
+		}
+
+		size_t getAvailable() const {
+			return _head.load(std::memory_order_acquire) - _tail.load(std::memory_order_acquire);
+		}
+
+		size_t getSpace() const {
+			return _buffer.size() - getAvailable();
+		}
+
+		size_t getCapacity() const {
+			return _buffer.size();
+		}
+
+	private:
+		std::vector<T> _buffer;
+		size_t _mask = 0;
+
+		// Kept apart so the two threads do not fight over one cache line
+		alignas(64) std::atomic<size_t> _head{0};
+		alignas(64) std::atomic<size_t> _tail{0};
+	};
+}
+
+#endif //SUPER_HAXAGON_RING_BUFFER_HPP
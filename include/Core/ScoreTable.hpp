@@ -0,0 +1,84 @@
+#ifndef SUPER_HAXAGON_SCORE_TABLE_HPP
+#define SUPER_HAXAGON_SCORE_TABLE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+// Only desktop POSIX systems have mmap and flock to share the table with
+#if (defined(__linux__) || defined(__APPLE__)) && !defined(SUPER_HAXAGON_NO_THREADS)
+#define SUPER_HAXAGON_SHARED_SCORES
+#endif
+
+namespace SuperHaxagon {
+	class Platform;
+
+	/**
+	 * A fixed size hash table of high scores in a memory mapped file.
+	 *
+	 * Several game processes sharing a user directory map the same file.
+	 * Slots are claimed and scores raised with compare and swap, so every
+	 * process sees the others' records straight away without locking.
+	 * The file lock is only taken while the table is created and while
+	 * scores.db is rewritten from it.
+	 *
+	 * On platforms without SUPER_HAXAGON_SHARED_SCORES the table never
+	 * opens and Scores keeps everything in its own memory.
+	 */
+	class ScoreTable {
+	public:
+		static constexpr uint32_t CAPACITY = 1 << 17;
+
+		// Holds the file lock for as long as it is alive
+		class Lock {
+		public:
+			explicit Lock(ScoreTable& table);
+			Lock(Lock&) = delete;
+			~Lock();
+
+		private:
+			ScoreTable& _table;
+		};
+
+		ScoreTable() = default;
+		ScoreTable(ScoreTable&) = delete;
+		~ScoreTable();
+
+		/**
+		 * Maps the table at path, creating it if needed. Returns false if
+		 * the table cannot be shared on this platform or the file is unusable.
+		 */
+		bool open(const std::string& path, Platform& platform);
+
+		bool isOpen() const {return _slots != nullptr;}
+
+		/**
+		 * Gets the score of a level, or 0 if the table does not have it
+		 */
+		int get(uint64_t id) const;
+
+		/**
+		 * Raises the score of a level if it is higher than the stored one.
+		 * Does nothing once the table is full.
+		 */
+		void raise(uint64_t id, int score);
+
+		/**
+		 * Merges every score in the table into scores, keeping the higher one
+		 */
+		void collect(std::unordered_map<uint64_t, int32_t>& scores) const;
+
+	private:
+		struct Slot;
+
+		Slot* find(uint64_t id, bool claim) const;
+
+		int _fd = -1;
+		void* _map = nullptr;
+		size_t _size = 0;
+		Slot* _slots = nullptr;
+	};
+}
+
+#endif //SUPER_HAXAGON_SCORE_TABLE_HPP
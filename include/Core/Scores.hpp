@@ -0,0 +1,97 @@
+#ifndef SUPER_HAXAGON_SCORES_HPP
+#define SUPER_HAXAGON_SCORES_HPP
+
+#include "Core/ScoreTable.hpp"
+#include "Core/Worker.hpp"
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace SuperHaxagon {
+	class Game;
+	class Platform;
+
+	/**
+	 * High scores keyed by LevelFactory::getId().
+	 *
+	 * Scores live in a hash map so lookups and updates do not depend on how
+	 * many levels or scores there are. Scores for levels that are not
+	 * currently installed are kept so they come back with the level.
+	 * Where the platform allows it, scores are also raised in a ScoreTable
+	 * shared with other game processes using the same user directory.
+	 *
+	 * New records are appended to a small journal by a background worker so
+	 * the game never waits on the disk. Every so often (and on shutdown)
+	 * the journal is folded back into scores.db, which is written to a
+	 * temporary file first and renamed over the old database.
+	 */
+	class Scores {
+	public:
+		static const char* SCORE_HEADER;
+		static const char* SCORE_HEADER_LEGACY;
+		static const char* SCORE_FOOTER;
+		static constexpr int COMPACT_AFTER = 16;
+
+		// Packed size of an id and a score, both in the database and the journal
+		static constexpr size_t RECORD_SIZE = sizeof(uint64_t) + sizeof(int32_t);
+
+		explicit Scores(Game& game);
+		Scores(Scores&) = delete;
+		~Scores();
+
+		/**
+		 * Reads scores.db and replays the journal on top of it
+		 */
+		bool load();
+
+		/**
+		 * Gets the high score of a level, or 0 if it was never played
+		 */
+		int get(uint64_t id) const;
+
+		/**
+		 * Sets the high score of a level if it beats the old one.
+		 * Returns true if it was a new high score.
+		 */
+		bool set(uint64_t id, int score);
+
+		/**
+		 * Appends the level's current high score to the journal
+		 */
+		void record(uint64_t id);
+
+		/**
+		 * Rewrites scores.db if the journal has anything in it
+		 */
+		void compact();
+
+	private:
+		using Record = std::pair<uint64_t, int32_t>;
+
+		static void packRecord(char* buffer, const Record& record);
+		static Record unpackRecord(const char* buffer);
+		bool loadDatabase(std::istream& stream);
+		bool loadLegacy(std::istream& stream);
+		int loadJournal(std::istream& stream);
+
+		Platform& _platform;
+
+		std::string _pathDatabase;
+		std::string _pathTemporary;
+		std::string _pathJournal;
+		std::string _pathTable;
+
+		std::unordered_map<uint64_t, int32_t> _scores;
+		int _journalEntries = 0;
+		ScoreTable _table;
+
+		// Destroyed first so queued writes finish while everything else is alive
+		Worker _worker;
+	};
+}
+
+#endif //SUPER_HAXAGON_SCORES_HPP
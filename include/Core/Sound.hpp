@@ -0,0 +1,67 @@
+#ifndef SUPER_HAXAGON_SOUND_HPP
+#define SUPER_HAXAGON_SOUND_HPP
+
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <vector>
+
+namespace SuperHaxagon {
+	/**
+	 * Decoded 16 bit PCM, interleaved if there is more than one channel.
+	 *
+	 * A sound can instead hold 4 bit IMA ADPCM, laid out in blocks the same
+	 * way as a WAVE file, which the mixer decodes a block at a time as it
+	 * plays. It takes a quarter of the memory for a little hiss.
+	 */
+	struct Sound {
+		// Largest compressed block accepted, so the mixer can make room for one up front
+		static constexpr size_t MAX_ALIGN = 2048;
+
+		int rate = 0;
+		int channels = 0;
+		std::vector<int16_t> samples;
+
+		std::vector<uint8_t> adpcm;
+		size_t adpcmAlign = 0;
+		size_t adpcmFrames = 0;
+
+		bool isCompressed() const {return adpcmAlign != 0;}
+		size_t getFrames() const {return isCompressed() ? adpcmFrames : channels ? samples.size() / channels : 0;}
+		size_t getBlockFrames() const {return isCompressed() ? (adpcmAlign - 4 * channels) * 2 / channels + 1 : 0;}
+		size_t getBlocks() const {return isCompressed() ? (adpcmFrames + getBlockFrames() - 1) / getBlockFrames() : 0;}
+
+		/**
+		 * Bytes held for the audio itself
+		 */
+		size_t getBytes() const {return samples.size() * sizeof(int16_t) + adpcm.size();}
+	};
+
+	/**
+	 * Reads a RIFF WAVE file with 8 or 16 bit mono or stereo PCM, or IMA
+	 * ADPCM which is kept compressed. Returns nullptr for anything else,
+	 * including ADPCM in blocks larger than Sound::MAX_ALIGN.
+	 */
+	std::unique_ptr<Sound> loadWav(std::istream& stream);
+
+	/**
+	 * Packs a PCM sound into IMA ADPCM blocks of blockAlign bytes, which
+	 * has to leave room for at least one group of 8 frames per channel
+	 * and be no more than Sound::MAX_ALIGN
+	 */
+	std::unique_ptr<Sound> compressAdpcm(const Sound& sound, size_t blockAlign = 512);
+
+	/**
+	 * Decodes a block of a compressed sound into out, which needs room for
+	 * getBlockFrames() frames. Returns how many frames the block had.
+	 */
+	size_t decodeAdpcm(const Sound& sound, size_t block, int16_t* out);
+
+	/**
+	 * Writes the 44 byte header of a 16 bit PCM WAVE file holding the given
+	 * number of frames. Write it again once the final length is known.
+	 */
+	void writeWavHeader(std::ostream& stream, int rate, int channels, uint32_t frames);
+}
+
+#endif //SUPER_HAXAGON_SOUND_HPP
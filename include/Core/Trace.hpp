@@ -0,0 +1,111 @@
+#ifndef SUPER_HAXAGON_TRACE_HPP
+#define SUPER_HAXAGON_TRACE_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#ifndef SUPER_HAXAGON_NO_THREADS
+#include <mutex>
+#endif
+
+namespace SuperHaxagon {
+	/**
+	 * Records what the game, the worker and the audio side were doing so
+	 * a capture can be opened in a Chrome trace viewer (chrome://tracing
+	 * or ui.perfetto.dev) and hitches lined up against loads and mixing.
+	 *
+	 * Nothing is kept until start(). A capture holds the most recent
+	 * EVENTS events, older ones are overwritten. Events can come from any
+	 * thread, but never from a device callback, which must not wait on
+	 * the lock.
+	 */
+	class Trace {
+	public:
+		static constexpr size_t EVENTS = 16384;
+		static constexpr size_t DETAIL = 24;
+
+		enum class Track : uint8_t {
+			GAME,
+			WORKER,
+			AUDIO,
+			JOBS,
+		};
+
+		struct Event {
+			const char* name;    // Has to outlive the capture, so a literal
+			char detail[DETAIL]; // Cut short if it does not fit
+			uint64_t start;      // Microseconds
+			uint32_t duration;   // Microseconds, 0 for an instant
+			Track track;
+			bool instant;
+		};
+
+		Trace() = default;
+		Trace(Trace&) = delete;
+
+		void start();
+
+		/**
+		 * Ends the capture and hands over its events, oldest first
+		 */
+		std::vector<Event> stop();
+
+		bool isRecording() const {return _recording.load(std::memory_order_relaxed);}
+
+		/**
+		 * Detail is copied into the event, so one formatted into a buffer
+		 * on the stack records without allocating
+		 */
+		void span(Track track, const char* name, uint64_t start, uint64_t end, const char* detail = "");
+		void span(Track track, const char* name, uint64_t start, uint64_t end, const std::string& detail);
+		void instant(Track track, const char* name, const char* detail = "");
+		void instant(Track track, const char* name, const std::string& detail);
+
+		/**
+		 * Microseconds since an arbitrary point, the same for every thread
+		 */
+		static uint64_t now();
+		static uint64_t toMicros(std::chrono::steady_clock::time_point time);
+
+		/**
+		 * Writes events out as Chrome trace event JSON
+		 */
+		static void write(std::ostream& stream, const std::vector<Event>& events);
+
+	private:
+		void push(const Event& event);
+
+		std::atomic<bool> _recording{false};
+		std::vector<Event> _events;
+		size_t _next = 0;
+		bool _wrapped = false;
+
+#ifndef SUPER_HAXAGON_NO_THREADS
+		std::mutex _mutex;
+#endif
+	};
+
+	/**
+	 * Records a span from construction to destruction
+	 */
+	class TraceSpan {
+	public:
+		TraceSpan(Trace& trace, Trace::Track track, const char* name, std::string detail = "");
+		TraceSpan(TraceSpan&) = delete;
+		~TraceSpan();
+
+	private:
+		Trace& _trace;
+		Trace::Track _track;
+		const char* _name;
+		std::string _detail;
+		bool _recording;
+		uint64_t _start;
+	};
+}
+
+#endif //SUPER_HAXAGON_TRACE_HPP
@@ -4,6 +4,7 @@
 #include "Structs.hpp"
 
 #include <algorithm>
+#include <cstdint>
 #include <memory>
 #include <random>
 
@@ -117,6 +118,18 @@ namespace SuperHaxagon {
 			_mt = std::make_unique<std::mt19937>(seed);
 		}
 
+		/**
+		 * Seeds the internal engine with a number drawn from itself,
+		 * so whatever happens next can be replayed from the result.
+		 * @return The new seed
+		 */
+		uint32_t reseed() {
+			const auto value = static_cast<uint32_t>((*_mt)());
+			std::seed_seq seed{value};
+			_mt = std::make_unique<std::mt19937>(seed);
+			return value;
+		}
+
 	private:
 		std::unique_ptr<std::mt19937> _mt;
 	};
@@ -0,0 +1,67 @@
+#ifndef SUPER_HAXAGON_VOICE_POOL_HPP
+#define SUPER_HAXAGON_VOICE_POOL_HPP
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace SuperHaxagon {
+	class AudioLoader;
+	class AudioPlayer;
+
+	/**
+	 * A fixed number of SFX voices shared by every sound effect.
+	 *
+	 * Each voice keeps a player for every sound that has played on it, so
+	 * playing one again restarts its player instead of instantiating a new
+	 * one. Once every sound has played on a voice, triggering one there
+	 * does not allocate, unless the voice was stolen, as the player that
+	 * was cut off is dropped to silence it.
+	 *
+	 * When every voice is busy, the voice with the lowest priority (the
+	 * oldest if there is a tie) is stolen, as long as it is not more
+	 * important than the new sound. Otherwise the new sound is dropped.
+	 */
+	class VoicePool {
+	public:
+		/**
+		 * Voices are given channels firstChannel to firstChannel + voices - 1
+		 */
+		explicit VoicePool(int voices, int firstChannel = 0);
+		VoicePool(VoicePool&) = delete;
+		~VoicePool();
+
+		/**
+		 * Returns false if the sound was dropped
+		 */
+		bool play(AudioLoader& audio);
+
+		/**
+		 * Stops and releases every player
+		 */
+		void clear();
+
+	private:
+		struct Player {
+			const AudioLoader* audio;
+			std::unique_ptr<AudioPlayer> player;
+		};
+
+		struct Voice {
+			std::vector<Player> players;
+			AudioPlayer* current = nullptr; // The last one played, if it is still around
+			int priority = 0;
+			uint64_t started = 0;
+
+			AudioPlayer* find(const AudioLoader& audio) const;
+		};
+
+		int pick(const AudioLoader& audio) const;
+
+		std::vector<Voice> _voices;
+		int _firstChannel;
+		uint64_t _played = 0;
+	};
+}
+
+#endif //SUPER_HAXAGON_VOICE_POOL_HPP
@@ -0,0 +1,51 @@
+#ifndef SUPER_HAXAGON_WORKER_HPP
+#define SUPER_HAXAGON_WORKER_HPP
+
+#include <deque>
+#include <functional>
+
+#ifndef SUPER_HAXAGON_NO_THREADS
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+
+namespace SuperHaxagon {
+	/**
+	 * A single background thread that runs jobs one at a time in the order
+	 * they were pushed. Platforms built with SUPER_HAXAGON_NO_THREADS run
+	 * the job immediately on the calling thread instead.
+	 */
+	class Worker {
+	public:
+		Worker();
+		Worker(Worker&) = delete;
+		~Worker();
+
+		/**
+		 * Queues a job to be run on the worker thread
+		 */
+		void push(std::function<void()> job);
+
+		/**
+		 * Blocks until every job queued so far has finished
+		 */
+		void flush();
+
+	private:
+		void run();
+
+		std::deque<std::function<void()>> _jobs;
+		bool _busy = false;
+		bool _quit = false;
+
+#ifndef SUPER_HAXAGON_NO_THREADS
+		std::mutex _mutex;
+		std::condition_variable _wake;
+		std::condition_variable _idle;
+		std::thread _thread;
+#endif
+	};
+}
+
+#endif //SUPER_HAXAGON_WORKER_HPP
@@ -15,6 +15,7 @@ namespace SuperHaxagon {
 		~AudioLoaderWav3DS() override;
 
 		std::unique_ptr<AudioPlayer> instantiate() override;
+		size_t getSize() const override {return _loaded ? _dataSize : 0;}
 
 	private:
 		u8* _data = nullptr;
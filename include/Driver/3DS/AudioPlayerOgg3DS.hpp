@@ -2,21 +2,26 @@
 #define SUPER_HAXAGON_AUDIO_PLAYER_OGG_3DS_HPP
 
 #include "Core/AudioPlayer.hpp"
+#include "Core/MusicClock.hpp"
 
 #include <3ds.h>
 #include <3ds/synchronization.h>
 
 #include <array>
+#include <memory>
 #include <string>
 
-struct stb_vorbis;
-
 namespace SuperHaxagon {
+	class OggStream;
+
 	class AudioPlayerOgg3DS : public AudioPlayer {
 	public:
 		static constexpr int THREAD_AFFINITY = -1;
 		static constexpr int THREAD_STACK_SZ = 32 * 1024;
 
+		// Decoded ahead of the wave buffers, which hold 600 ms themselves
+		static constexpr int STREAM_LATENCY_MS = 500;
+
 		explicit AudioPlayerOgg3DS(const std::string& path);
 		~AudioPlayerOgg3DS() override;
 
@@ -32,8 +37,9 @@ namespace SuperHaxagon {
 		float getTime() const override;
 
 	private:
-		static bool audioDecode(stb_vorbis* file, ndspWaveBuf* buff, int channel);
+		static bool audioDecode(OggStream& stream, ndspWaveBuf* buff, int channel);
 		static void audioThread(void*);
+		void publish();
 
 		// 120 ms per buffer
 		static unsigned int getSamplesPerBuff(unsigned int sampleRate);
@@ -41,14 +47,14 @@ namespace SuperHaxagon {
 
 		Thread _thread = nullptr;
 		int16_t* _audioBuffer = nullptr;
-		stb_vorbis* _oggFile = nullptr;
+		std::unique_ptr<OggStream> _stream;
 		std::array<ndspWaveBuf, 3> _waveBuffs{};
+		std::array<float, 3> _waveBuffTimes{}; // Song position at the start of each buffer
+		MusicClock _clock;
 		volatile bool _loaded = false;   // if data is loaded
 		volatile bool _loop = false;     // if audio should loop
 		volatile bool _quit = false;     // if thread should be shut down
 		volatile int _channel = 0;
-		volatile uint64_t _start = 0;
-		volatile uint64_t _diff = 0;
 	};
 }
 
@@ -1,12 +1,12 @@
 #ifndef SUPER_HAXAGON_PLATFORM_3DS_HPP
 #define SUPER_HAXAGON_PLATFORM_3DS_HPP
 
+#include "Core/MessageHistory.hpp"
 #include "Core/Platform.hpp"
+#include "Core/VoicePool.hpp"
 
 #include <citro2d.h>
 
-#include <deque>
-
 static const int MAX_TRACKS = 4;
 
 namespace SuperHaxagon {
@@ -24,12 +24,16 @@ namespace SuperHaxagon {
 		std::unique_ptr<Font> loadFont(const std::string& partial, int size) override;
 
 		void playSFX(AudioLoader& audio) override;
-		void playBGM(AudioLoader& audio) override;
+		std::unique_ptr<AudioPlayer> swapBGM(std::unique_ptr<AudioPlayer> bgm) override;
 
 		std::string getButtonName(const Buttons& button) override;
 		Buttons getPressed() override;
 		Point getScreenDim() const override;
 
+		// The second core belongs to the system unless asked for, and even
+		// then only a slice of it, so jobs stay on the game's thread
+		size_t getCores() const override {return 1;}
+
 		void screenBegin() override;
 		void screenSwap() override;
 		void screenFinalize() override;
@@ -38,12 +42,15 @@ namespace SuperHaxagon {
 		std::unique_ptr<Twist> getTwister() override;
 
 		void shutdown() override;
-		void message(Dbg dbg, const std::string& where, const std::string& message) override;
+
+	protected:
+		void output(Dbg dbg, const std::string& where, const std::string& message) override;
 
 	private:
-		std::unique_ptr<AudioPlayer> _sfx[MAX_TRACKS]{};
+		// Channel 0 is the BGM's
+		VoicePool _sfx{MAX_TRACKS, 1};
 
-		std::deque<std::pair<Dbg, std::string>> _messages{};
+		MessageHistory _messages;
 
 		C3D_RenderTarget* _top = nullptr;
 		C3D_RenderTarget* _bot = nullptr;
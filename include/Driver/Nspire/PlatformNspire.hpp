@@ -26,7 +26,6 @@ namespace SuperHaxagon {
 		std::unique_ptr<Font> loadFont(const std::string& partial, int size) override;
 		
 		void playSFX(AudioLoader&) override {}
-		void playBGM(AudioLoader& audio) override;
 		
 		std::string getButtonName(const Buttons& button) override;
 		Buttons getPressed() override;
@@ -37,11 +36,13 @@ namespace SuperHaxagon {
 		void drawPoly(const Color& color, const std::vector<Point>& points) override;
 
 		void shutdown() override;
-		void message(Dbg dbg, const std::string& where, const std::string& message) override;
 		Supports supports() override;
 
 		std::unique_ptr<Twist> getTwister() override;
 
+	protected:
+		void output(Dbg dbg, const std::string& where, const std::string& message) override;
+
 	private:
 		float _dilation = 1.0;
 		Gc _gc{};
@@ -4,18 +4,27 @@
 #include "Core/AudioLoader.hpp"
 #include "Driver/PSP/AudioPlayerPSP.hpp"
 
+#include <memory>
+#include <string>
+
 namespace SuperHaxagon {
 	enum class Location;
+	class Mixer;
 	class Platform;
+	struct Sound;
 
 	class AudioLoaderPSP : public AudioLoader {
 	public:
-		AudioLoaderPSP(const std::string& path, Stream stream);
+		AudioLoaderPSP(Mixer& mixer, const std::string& path, Stream stream);
 		~AudioLoaderPSP() override = default;
 
 		std::unique_ptr<AudioPlayer> instantiate() override;
+		size_t getSize() const override;
 
 	private:
+		Mixer& _mixer;
+		std::shared_ptr<const Sound> _sound;
+		std::string _streamPath;
 	};
 }
 
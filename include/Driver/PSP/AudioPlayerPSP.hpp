@@ -3,21 +3,36 @@
 
 #include "Core/AudioPlayer.hpp"
 
+#include <memory>
+
 namespace SuperHaxagon {
+	class Mixer;
+	class OggStream;
+	struct Sound;
+
 	class AudioPlayerPSP : public AudioPlayer {
 	public:
-		AudioPlayerPSP();
-		~AudioPlayerPSP() override = default;
+		AudioPlayerPSP(Mixer& mixer, std::shared_ptr<const Sound> sound);
+		AudioPlayerPSP(Mixer& mixer, std::shared_ptr<OggStream> stream);
+		~AudioPlayerPSP() override;
 
 		void setChannel(int) override {}
-		void setLoop(bool) override {}
+		void setLoop(bool loop) override;
 
 		void play() override;
 		void pause() override;
 		bool isDone() const override;
 		float getTime() const override;
+		void setVolume(float volume) override;
 
 	private:
+		Mixer& _mixer;
+		std::shared_ptr<const Sound> _sound;
+		std::shared_ptr<OggStream> _stream;
+		int _voice = -1;
+		bool _loop = false;
+		bool _paused = false;
+		float _volume = 1.0f;
 	};
 }
 
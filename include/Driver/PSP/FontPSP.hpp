@@ -20,6 +20,9 @@ namespace SuperHaxagon {
 		float getWidth(const std::string& text) const override;
 		void draw(const Color& color, const Point& position, Alignment alignment, const std::string& text) override;
 
+		// The atlas is in VRAM, but that is even tighter than RAM
+		size_t getSize() const override {return _tex ? _tex_dim * _tex_dim * 4 : 0;}
+
 	private:
 		struct Vertex {
 			float u;
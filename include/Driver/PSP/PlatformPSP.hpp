@@ -2,18 +2,25 @@
 #define SUPER_HAXAGON_PLATFORM_PSP_HPP
 
 #include "Core/Platform.hpp"
+#include "Core/VoicePool.hpp"
 
+#include <memory>
 #include <pspkerneltypes.h>
 
 #define VERSION_MAJOR 1
 #define VERSION_MINOR 0
 
 namespace SuperHaxagon {
+	class Mixer;
+
 	class PlatformPSP : public Platform {
 	public:
+		// Leaves mixer voices for the BGM and anything still stopping
+		static constexpr int SFX_VOICES = 8;
+
 		explicit PlatformPSP(Dbg dbg, int argc, char** argv);
 		PlatformPSP(PlatformPSP&) = delete;
-		~PlatformPSP() override = default;
+		~PlatformPSP() override;
 
 		bool loop() override;
 		float getDilation() override;
@@ -23,7 +30,8 @@ namespace SuperHaxagon {
 		std::unique_ptr<Font> loadFont(const std::string& partial, int size) override;
 
 		void playSFX(AudioLoader& audio) override;
-		void playBGM(AudioLoader& audio) override;
+		float getAudioFill() const override;
+		uint32_t getAudioUnderruns() const override;
 
 		std::string getButtonName(const Buttons& button) override;
 		Buttons getPressed() override;
@@ -36,9 +44,11 @@ namespace SuperHaxagon {
 		std::unique_ptr<Twist> getTwister() override;
 
 		void shutdown() override;
-		void message(Dbg dbg, const std::string& where, const std::string& message) override;
 		Supports supports() override;
 
+	protected:
+		void output(Dbg dbg, const std::string& where, const std::string& message) override;
+
 	private:
 		// Resolution of the PSP display in pixels.
 		static constexpr unsigned _width = 480;
@@ -48,6 +58,7 @@ namespace SuperHaxagon {
 
 		static int exitCallback(int, int, void*);
 		static int callbackThread(SceSize, void*);
+		static void audioCallback(void* buffer, unsigned int frames, void* data);
 
 		const std::string _game_dir;
 		const std::string _rom_dir;
@@ -57,6 +68,9 @@ namespace SuperHaxagon {
 
 		uint64_t _dbg_t_start = 0;
 
+		std::unique_ptr<Mixer> _mixer;
+		VoicePool _sfx{SFX_VOICES};
+
 		bool initCallbacks();
 		bool initVideo();
 		bool initAudio();
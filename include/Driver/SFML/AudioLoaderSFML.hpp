@@ -6,6 +6,8 @@
 #include <SFML/Audio/Music.hpp>
 #include <SFML/Audio/SoundBuffer.hpp>
 
+#include <string>
+
 namespace SuperHaxagon {
 	class AudioLoaderSFML : public AudioLoader {
 	public:
@@ -13,9 +15,11 @@ namespace SuperHaxagon {
 		~AudioLoaderSFML() override;
 
 		std::unique_ptr<AudioPlayer> instantiate() override;
+		size_t getSize() const override;
 
 	private:
 		Stream _stream = Stream::NONE;
+		std::string _path;
 
 		std::unique_ptr<sf::SoundBuffer> _buffer;
 		std::unique_ptr<sf::Music> _music;
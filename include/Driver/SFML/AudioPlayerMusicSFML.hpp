@@ -2,6 +2,7 @@
 #define SUPER_HAXAGON_AUDIO_PLAYER_MUSIC_SFML_HPP
 
 #include "Core/AudioPlayer.hpp"
+#include "Core/MusicClock.hpp"
 
 #include <SFML/Audio/Music.hpp>
 
@@ -20,9 +21,15 @@ namespace SuperHaxagon {
 		void pause() override;
 		bool isDone() const override;
 		float getTime() const override;
+		void setVolume(float volume) override;
 
 	private:
 		std::unique_ptr<sf::Music> _music;
+
+		// SFML only moves the offset when OpenAL does, so the clock fills the gaps
+		mutable MusicClock _clock;
+		mutable sf::Int64 _offset = -1;
+		mutable bool _running = false;
 	};
 }
 
@@ -0,0 +1,74 @@
+#ifndef SUPER_HAXAGON_INPUT_SAMPLER_SFML_HPP
+#define SUPER_HAXAGON_INPUT_SAMPLER_SFML_HPP
+
+#include "Core/Platform.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace SuperHaxagon {
+	/**
+	 * Watches the keyboard from a thread of its own, many times a frame,
+	 * and notes when left and right each go down and come back up. The
+	 * game can then ask how long each was held since it last asked,
+	 * instead of only whether it is down at that moment.
+	 *
+	 * It only runs between start() and stop(), and sleeps while the window
+	 * is out of focus. While it runs it is the only thing that asks the
+	 * keyboard anything, so getPressed() hands back what it last saw
+	 * rather than asking again from the game's thread.
+	 */
+	class InputSamplerSFML {
+	public:
+		using Clock = std::chrono::steady_clock;
+
+		InputSamplerSFML() = default;
+		InputSamplerSFML(InputSamplerSFML&) = delete;
+		~InputSamplerSFML();
+
+		void start();
+		void stop();
+		bool isRunning() const {return _thread.joinable();}
+
+		/**
+		 * Nothing counts as held while the window is out of focus
+		 */
+		void setFocus(bool focus);
+
+		/**
+		 * What is down, as of the last look if running, otherwise now
+		 */
+		Buttons getPressed();
+
+		/**
+		 * How much of the time since the last call each was held for
+		 */
+		Held take();
+
+	private:
+		struct Key {
+			bool down = false;
+			Clock::time_point since{}; // When it went down, or the last take() if later
+			Clock::duration held{};    // Held and let go of since the last take()
+		};
+
+		void run();
+		void sample(Key& key, bool down, Clock::time_point now);
+		Clock::duration collect(Key& key, Clock::time_point now);
+
+		std::atomic<bool> _running{false};
+		std::atomic<bool> _focus{true};
+		std::mutex _mutex;
+		std::condition_variable _wake; // Focus coming back, or stopping
+		Buttons _pressed{};
+		Key _left;
+		Key _right;
+		Clock::time_point _taken;
+		std::thread _thread;
+	};
+}
+
+#endif //SUPER_HAXAGON_INPUT_SAMPLER_SFML_HPP
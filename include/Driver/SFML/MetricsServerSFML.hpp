@@ -0,0 +1,37 @@
+#ifndef SUPER_HAXAGON_METRICS_SERVER_SFML_HPP
+#define SUPER_HAXAGON_METRICS_SERVER_SFML_HPP
+
+#include <SFML/Network/TcpListener.hpp>
+
+#include <atomic>
+#include <thread>
+
+namespace SuperHaxagon {
+	class Metrics;
+
+	/**
+	 * Serves the metrics over HTTP on localhost for a Prometheus scraper,
+	 * from a thread of its own. Any path other than /metrics is a 404.
+	 */
+	class MetricsServerSFML {
+	public:
+		explicit MetricsServerSFML(Metrics& metrics);
+		MetricsServerSFML(MetricsServerSFML&) = delete;
+		~MetricsServerSFML();
+
+		/**
+		 * Starts serving, or returns false if the port could not be bound
+		 */
+		bool listen(unsigned short port);
+
+	private:
+		void run();
+
+		Metrics& _metrics;
+		sf::TcpListener _listener;
+		std::atomic<bool> _running{false};
+		std::thread _thread;
+	};
+}
+
+#endif //SUPER_HAXAGON_METRICS_SERVER_SFML_HPP
@@ -1,16 +1,32 @@
 #ifndef SUPER_HAXAGON_PLATFORM_SFML_HPP
 #define SUPER_HAXAGON_PLATFORM_SFML_HPP
 
+#include "Core/FramePacer.hpp"
 #include "Core/Platform.hpp"
+#include "Core/VoicePool.hpp"
+#include "Driver/SFML/InputSamplerSFML.hpp"
+#include "Driver/SFML/MetricsServerSFML.hpp"
 
 #include <SFML/Graphics.hpp>
 
-#include <deque>
-
 namespace SuperHaxagon {
 	class AudioLoader;
 	class PlatformSFML : public Platform {
 	public:
+		static constexpr int SFX_VOICES = 16;
+
+		// Antialiasing at full quality, lowered by the quality governor
+		static constexpr unsigned SAMPLES = 8;
+
+		// Set to a port number to serve metrics on localhost
+		static constexpr const char* METRICS_PORT_ENV = "SUPER_HAXAGON_METRICS";
+
+		// Set to 0 to leave frames to vsync alone, to compare against pacing
+		static constexpr const char* PACING_ENV = "SUPER_HAXAGON_PACING";
+
+		// Sleeping can overshoot by a millisecond or so, so the last of a wait is spun
+		static constexpr float SPIN_SECONDS = 0.002f;
+
 		PlatformSFML(Dbg dbg, sf::VideoMode video);
 		~PlatformSFML() override;
 
@@ -22,30 +38,45 @@ namespace SuperHaxagon {
 		std::unique_ptr<Font> loadFont(const std::string& partial, int size) override;
 
 		void playSFX(AudioLoader& audio) override;
-		void playBGM(AudioLoader& audio) override;
 
 		std::string getButtonName(const Buttons& button) override;
 		Buttons getPressed() override;
+		Held getHeld() override;
+		void setSampling(bool sampling) override;
 		Point getScreenDim() const override;
 
 		void screenBegin() override;
 		void screenFinalize() override;
 		void drawPoly(const Color& color, const std::vector<Point>& points) override;
 
+		unsigned getMaxSamples() const override;
+		void setSamples(unsigned samples) override;
+
 		std::unique_ptr<Twist> getTwister() override = 0;
 
 		void shutdown() override = 0;
-		void message(Dbg dbg, const std::string& where, const std::string& message) override = 0;
 
 		sf::RenderWindow& getWindow() const {return *_window;}
 
+	protected:
+		void output(Dbg dbg, const std::string& where, const std::string& message) override = 0;
+
 	private:
+		void startMetrics();
+		void waitUntil(FramePacer::Clock::time_point wake);
+		void createWindow(sf::VideoMode video);
+
 		bool _loaded = false;
-		bool _focus = true;
+		bool _metricsChecked = false;
+		bool _pacing = true;
 		float _delta = 0.0;
+		unsigned _samples = SAMPLES;
 		sf::Clock _clock;
+		FramePacer _pacer;
 		std::unique_ptr<sf::RenderWindow> _window;
-		std::deque<std::unique_ptr<AudioPlayer>> _sfx;
+		VoicePool _sfx{SFX_VOICES};
+		std::unique_ptr<MetricsServerSFML> _metricsServer;
+		std::unique_ptr<InputSamplerSFML> _input;
 	};
 }
 
@@ -15,6 +15,7 @@ namespace SuperHaxagon {
 		~AudioLoaderSwitch() override;
 
 		std::unique_ptr<AudioPlayer> instantiate() override;
+		size_t getSize() const override;
 
 	private:
 		Mix_Music* _music = nullptr;
@@ -2,9 +2,12 @@
 #define SUPER_HAXAGON_AUDIO_PLAYER_MUS_SWITCH_HPP
 
 #include "Core/AudioPlayer.hpp"
+#include "Core/MusicClock.hpp"
 
 #include <SDL2/SDL_mixer.h>
 
+#include <atomic>
+
 namespace SuperHaxagon {
 	class AudioPlayerMusSwitch : public AudioPlayer {
 	public:
@@ -18,15 +21,19 @@ namespace SuperHaxagon {
 		void pause() override;
 		bool isDone() const override;
 		float getTime() const override;
-		float getNow() const;
 
 	private:
+		static void postMix(void* data, Uint8* stream, int length);
+
 		bool _loop = false;
 		Mix_Music* _music;
 
-		// Timing controls
-		float _start = 0;
-		float _diff = 0;
+		// Timing controls, counted from what SDL_mixer hands to the device
+		MusicClock _clock;
+		std::atomic<bool> _restart{false};
+		uint32_t _played = 0; // Audio thread only
+		int _rate = 0;
+		int _frameBytes = 0;
 	};
 }
 
@@ -11,16 +11,17 @@ namespace SuperHaxagon {
 		explicit AudioPlayerSfxSwitch(Mix_Chunk* sfx);
 		~AudioPlayerSfxSwitch() override;
 
-		void setChannel(int) override {}
+		void setChannel(int channel) override {_channel = channel;}
 		void setLoop(bool) override {}
 
 		void play() override;
 		void pause() override {}
-		bool isDone() const override {return true;}
+		bool isDone() const override;
 		float getTime() const override {return 0.0;}
 
 	private:
 		Mix_Chunk* _sfx;
+		int _channel = -1;
 	};
 }
 
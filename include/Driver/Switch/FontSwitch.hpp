@@ -31,6 +31,7 @@ namespace SuperHaxagon {
 		float getHeight() const override;
 		float getWidth(const std::string& text) const override;
 		void draw(const Color& color, const Point& position, Alignment alignment, const std::string& text) override;
+		size_t getSize() const override {return _loaded ? _texWidth * _texHeight : 0;}
 
 	private:
 		PlatformSwitch& _platform;
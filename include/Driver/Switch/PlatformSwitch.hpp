@@ -1,7 +1,9 @@
 #ifndef SUPER_HAXAGON_PLATFORM_SWITCH_HPP
 #define SUPER_HAXAGON_PLATFORM_SWITCH_HPP
 
+#include "Core/MessageHistory.hpp"
 #include "Core/Platform.hpp"
+#include "Core/VoicePool.hpp"
 
 #include "RenderTarget.hpp"
 
@@ -17,6 +19,9 @@ namespace SuperHaxagon {
 
 	class PlatformSwitch : public Platform {
 	public:
+		// One SFX voice per SDL_mixer channel
+		static constexpr int SFX_VOICES = 16;
+
 		explicit PlatformSwitch(Dbg dbg);
 		PlatformSwitch(PlatformSwitch&) = delete;
 		~PlatformSwitch() override;
@@ -29,7 +34,7 @@ namespace SuperHaxagon {
 		std::unique_ptr<AudioLoader> loadAudio(const std::string& partial, Stream stream, Location location) override;
 
 		void playSFX(AudioLoader& audio) override;
-		void playBGM(AudioLoader& audio) override;
+		std::unique_ptr<AudioPlayer> swapBGM(std::unique_ptr<AudioPlayer> bgm) override;
 
 		std::string getButtonName(const Buttons& button) override;
 		Buttons getPressed() override;
@@ -42,12 +47,14 @@ namespace SuperHaxagon {
 		std::unique_ptr<Twist> getTwister() override;
 
 		void shutdown() override;
-		void message(Dbg dbg, const std::string& where, const std::string& message) override;
 
 		float getAndIncrementZ();
 		void addRenderTarget(std::shared_ptr<RenderTarget<Vertex>>& target) {_targetVertex.emplace_back(target);}
 		void addRenderTarget(std::shared_ptr<RenderTarget<VertexUV>>& target) {_targetVertexUV.emplace_back(target);}
 
+	protected:
+		void output(Dbg dbg, const std::string& where, const std::string& message) override;
+
 	private:
 		bool initEGL();
 
@@ -55,6 +62,7 @@ namespace SuperHaxagon {
 		void render(std::deque<std::shared_ptr<RenderTarget<T>>> targets, bool transparent);
 
 		bool _loaded = false;
+		VoicePool _sfx{SFX_VOICES};
 
 		unsigned int _width = 1280;
 		unsigned int _height = 720;
@@ -71,7 +79,7 @@ namespace SuperHaxagon {
 		EGLSurface _surface{};
 
 		std::ofstream _console;
-		std::deque<std::pair<Dbg, std::string>> _messages{};
+		MessageHistory _messages;
 		std::deque<std::shared_ptr<RenderTarget<Vertex>>> _targetVertex{};
 		std::deque<std::shared_ptr<RenderTarget<VertexUV>>> _targetVertexUV{};
 	};
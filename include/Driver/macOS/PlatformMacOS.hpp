@@ -13,9 +13,11 @@ namespace SuperHaxagon {
 		std::string getPath(const std::string& partial, Location location) override;
 
 		void shutdown() override {};
-		void message(Dbg dbg, const std::string& where, const std::string& message) override;
 
 		std::unique_ptr<Twist> getTwister() override;
+
+	protected:
+		void output(Dbg dbg, const std::string& where, const std::string& message) override;
 	};
 }
 
@@ -4,6 +4,7 @@
 #include "Core/Structs.hpp"
 #include "Core/Platform.hpp"
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
@@ -21,9 +22,20 @@ namespace SuperHaxagon {
 		static const char* LEVEL_HEADER;
 		static const char* LEVEL_FOOTER;
 
-		LevelFactory(std::istream& stream, std::vector<std::shared_ptr<PatternFactory>>& shared, Location location, Platform& platform, size_t levelIndexOffset);
+		LevelFactory(std::istream& stream, std::vector<std::shared_ptr<PatternFactory>>& shared, Location location, Platform& platform);
 		LevelFactory(const LevelFactory&) = delete;
 
+		/**
+		 * The next index is read relative to the level's own file. This
+		 * moves it past the levels that were loaded before that file.
+		 */
+		void offsetNextIndex(size_t levelIndexOffset);
+
+		/**
+		 * Hashes the strings that identify a level into a stable 64 bit id
+		 */
+		static uint64_t makeId(const std::string& name, const std::string& difficulty, const std::string& mode, const std::string& creator);
+
 		std::unique_ptr<Level> instantiate(Twist& rng, float renderDistance) const;
 
 		bool isLoaded() const {return _loaded;}
@@ -38,7 +50,7 @@ namespace SuperHaxagon {
 		const std::string& getMusic() const {return _music;}
 
 		Location getLocation() const {return _location;}
-		int getHighScore() const {return _highScore;}
+		uint64_t getId() const {return _id;}
 		int getSpeedPulse() const {return _speedPulse;}
 		float getSpeedCursor() const {return _speedCursor;}
 		float getSpeedRotation() const {return _speedRotation;}
@@ -46,8 +58,6 @@ namespace SuperHaxagon {
 		int getNextIndex() const {return _nextIndex;}
 		float getNextTime() const {return _nextTime;}
 
-		bool setHighScore(int score);
-
 	private:
 		std::vector<std::shared_ptr<PatternFactory>> _patterns;
 		std::map<LocColor, std::vector<Color>> _colors;
@@ -58,9 +68,10 @@ namespace SuperHaxagon {
 		std::string _creator;
 		std::string _music;
 
+		MemoryCharge _charge;
 		Location _location = Location::ROM;
 
-		int _highScore = 0;
+		uint64_t _id = 0;
 		int _speedPulse = 0;
 		int _nextIndex = -1;
 		float _speedWall = 0;
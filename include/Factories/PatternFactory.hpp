@@ -1,6 +1,7 @@
 #ifndef SUPER_HAXAGON_PATTERN_FACTORY_HPP
 #define SUPER_HAXAGON_PATTERN_FACTORY_HPP
 
+#include "Core/Memory.hpp"
 #include "Factories/WallFactory.hpp"
 #include "Objects/Pattern.hpp"
 
@@ -27,6 +28,7 @@ namespace SuperHaxagon {
 	private:
 		std::vector<WallFactory> _walls;
 		std::string _name;
+		MemoryCharge _charge;
 		int _sides = 0;
 		bool _loaded = false;
 	};
@@ -1,11 +1,13 @@
 #ifndef SUPER_HAXAGON_LEVEL_HPP
 #define SUPER_HAXAGON_LEVEL_HPP
 
+#include "Core/Memory.hpp"
 #include "Core/Structs.hpp"
 #include "Objects/Pattern.hpp"
 
 #include <deque>
 #include <map>
+#include <utility>
 
 namespace SuperHaxagon {	
 	class Game;
@@ -55,6 +57,7 @@ namespace SuperHaxagon {
 
 		// Stuff for Win control
 		std::deque<Pattern>& getPatterns() {return _patterns;}
+		const std::deque<Pattern>& getPatterns() const {return _patterns;}
 		void setWinMultiplierRot(const float multiplier) {_multiplierRot = multiplier;}
 		void setWinMultiplierWalls(const float multiplier) {_multiplierWalls = multiplier;}
 		void setWinAutoPatternCreate(const bool autoPatternCreate) {_autoPatternCreate = autoPatternCreate;}
@@ -65,6 +68,11 @@ namespace SuperHaxagon {
 		void setWinSides(int sides);
 		void resetColors();
 
+		/**
+		 * Kept up to date with the live patterns on every update
+		 */
+		void setCharge(MemoryCharge charge) {_charge = std::move(charge);}
+
 	private:
 		void advanceWalls(Twist& rng, float patternDistDelete, float patternDistCreate);
 		void reverseWalls(Twist& rng, float patternDistDelete, float patternDistCreate);
@@ -73,6 +81,7 @@ namespace SuperHaxagon {
 		const LevelFactory* _factory;
 
 		std::deque<Pattern> _patterns;
+		MemoryCharge _charge;
 
 		bool _autoPatternCreate = false;
 		bool _showCursor = true;
@@ -18,6 +18,11 @@ namespace SuperHaxagon {
 		void advance(float speed);
 		Movement collision(float cursorHeight, float cursorPos, float cursorStep, int sides) const;
 		std::vector<Point> calcPoints(const Point& focus, float rotation, float sides, float offset, float scale) const;
+
+		/**
+		 * Same as above, but reuses the quad's memory
+		 */
+		void calcPoints(std::vector<Point>& quad, const Point& focus, float rotation, float sides, float offset, float scale) const;
 		static Point calcPoint(const Point& focus, float rotation, float overflow, float distance, float sides, int side);
 
 		float getDistance() const {return _distance;}
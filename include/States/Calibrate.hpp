@@ -0,0 +1,70 @@
+#ifndef SUPER_HAXAGON_CALIBRATE_HPP
+#define SUPER_HAXAGON_CALIBRATE_HPP
+
+#include "State.hpp"
+
+#include <vector>
+
+namespace SuperHaxagon {
+	class Game;
+	class Platform;
+	class LevelFactory;
+
+	/**
+	 * Measures how far the screen and the speakers lag behind the game.
+	 *
+	 * The player taps along to a click they can only hear, then to a flash
+	 * they can only see. Their reaction time is in both, so the difference
+	 * between the two is how much later the screen shows something than
+	 * the speakers play it. That difference becomes the game's latency.
+	 */
+	class Calibrate : public State {
+	public:
+		static constexpr float FRAMES_PER_BEAT = 30.0f;
+		static constexpr float FRAMES_PER_FLASH = 4.0f;
+
+		// The first few beats are for the player to find the rhythm
+		static constexpr int SKIP_BEATS = 4;
+		static constexpr size_t TAPS = 8;
+
+		Calibrate(Game& game, LevelFactory& selected);
+		Calibrate(Calibrate&) = delete;
+		~Calibrate() override;
+
+		std::unique_ptr<State> update(float dilation) override;
+		void drawTop(float scale) override;
+		void drawBot(float scale) override;
+		const char* getName() const override {return "Calibrate";}
+		void enter() override;
+
+	private:
+		enum class Phase {
+			AUDIO,
+			VIDEO,
+			DONE,
+		};
+
+		void begin(Phase phase);
+		static float median(std::vector<float>& taps);
+
+		Game& _game;
+		Platform& _platform;
+		LevelFactory& _selected;
+
+		Phase _phase = Phase::AUDIO;
+
+		// Down last frame, so a tap counts once. Whatever led here has to be let go first.
+		bool _backHeld = true;
+		bool _selectHeld = true;
+
+		float _frames = 0;
+		int _beat = 0;
+
+		// How late each tap was from its beat, in frames
+		std::vector<float> _audio;
+		std::vector<float> _video;
+		float _latency = 0;
+	};
+}
+
+#endif //SUPER_HAXAGON_CALIBRATE_HPP
@@ -5,29 +5,36 @@
 
 #include "Core/Structs.hpp"
 
+#include <memory>
+#include <vector>
+
 namespace SuperHaxagon {
 	enum class Location;
 	class Game;
+	class LevelFactory;
 	class Platform;
 
 	class Load : public State {
 	public:
 		static const char* PROJECT_HEADER;
 		static const char* PROJECT_FOOTER;
-		static const char* SCORE_HEADER;
-		static const char* SCORE_FOOTER;
 
 		explicit Load(Game& game);
 		Load(Load&) = delete;
 		~Load() override;
 
-		bool loadLevels(std::istream& stream, Location location) const;
-		bool loadScores(std::istream& stream) const;
+		/**
+		 * Reads a file of patterns and levels, adding the levels to the
+		 * end of levels as they load, even if a later one fails. Their next
+		 * indices are still relative to the file. Safe on any thread.
+		 */
+		static bool loadLevels(std::istream& stream, Location location, Platform& platform, std::vector<std::unique_ptr<LevelFactory>>& levels);
 
 		std::unique_ptr<State> update(float dilation) override;
 		void enter() override;
 		void drawTop(float) override {};
 		void drawBot(float) override {};
+		const char* getName() const override {return "Load";}
 
 	private:
 		Game& _game;
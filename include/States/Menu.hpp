@@ -25,16 +25,24 @@ namespace SuperHaxagon {
 		std::unique_ptr<State> update(float dilation) override;
 		void drawTop(float scale) override;
 		void drawBot(float scale) override;
+		const char* getName() const override {return "Menu";}
 		void enter() override;
 		void exit() override {};
 
 	private:
+		void prefetch() const;
+
 		Game& _game;
 		Platform& _platform;
 
 		float _frameRotation = FRAMES_PER_TRANSITION;
 		float _frameBackgroundColor = FRAMES_PER_COLOR;
 		int _transitionDirection = 0;
+		bool _starting = false;
+
+		// Down last frame, so whatever led here has to be let go before it counts
+		bool _backHeld = true;
+		bool _selectHeld = true;
 
 		std::vector<std::unique_ptr<LevelFactory>>::const_iterator _selected;
 		std::map<LocColor, Color> _color;
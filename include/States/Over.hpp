@@ -25,6 +25,8 @@ namespace SuperHaxagon {
 		std::unique_ptr<State> update(float dilation) override;
 		void drawTop(float scale) override;
 		void drawBot(float scale) override;
+		const char* getName() const override {return "Over";}
+		const Level* getLevel() const override {return _level.get();}
 		void enter() override;
 
 	private:
@@ -38,6 +40,7 @@ namespace SuperHaxagon {
 		float _score = 0;
 		float _frames = 0;
 		float _offset = 1.0;
+		bool _loading = false;
 	};
 }
 
@@ -3,12 +3,15 @@
 
 #include "State.hpp"
 
+#include <cstdint>
+
 namespace SuperHaxagon {
 	class Game;
 	class AudioLoader;
 	class Level;
 	class LevelFactory;
 	class Platform;
+	enum class RunEnd : uint8_t;
 
 	class Play : public State {
 	public:
@@ -24,14 +27,20 @@ namespace SuperHaxagon {
 		std::unique_ptr<State> update(float dilation) override;
 		void drawTop(float scale) override;
 		void drawBot(float scale) override;
+		const char* getName() const override {return "Play";}
+		const Level* getLevel() const override {return _level.get();}
+		bool isSteady() const override {return true;}
 		void enter() override;
 		void exit() override;
 
 	private:
+		void record(RunEnd cause) const;
+
 		Game& _game;
 		Platform& _platform;
 		LevelFactory& _factory;
 		LevelFactory& _selected;
+		uint32_t _seed;
 		std::unique_ptr<Level> _level;
 
 		float _scalePrev = 0;
@@ -39,6 +48,13 @@ namespace SuperHaxagon {
 		float _score = 0;
 		float _skewFrame = 0.0;
 		float _skewDirection = 1.0;
+		float _dilationTotal = 0;
+		int _updates = 0;
+
+		uint64_t _eventSpin;
+		uint64_t _eventInvert;
+		uint64_t _eventPulseLarge;
+		uint64_t _eventPulseSmall;
 	};
 }
 
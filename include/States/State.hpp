@@ -4,6 +4,8 @@
 #include <memory>
 
 namespace SuperHaxagon {
+	class Level;
+
 	class State {
 	public:
 		virtual ~State() = default;
@@ -13,6 +15,21 @@ namespace SuperHaxagon {
 		virtual void drawBot(float scale) = 0;
 		virtual void enter() {};
 		virtual void exit() {};
+
+		/**
+		 * Shown in traces when the game moves to this state
+		 */
+		virtual const char* getName() const = 0;
+
+		/**
+		 * The level on screen, if there is one, for the performance overlay
+		 */
+		virtual const Level* getLevel() const {return nullptr;}
+
+		/**
+		 * Once settled in, frames in this state should not touch the heap
+		 */
+		virtual bool isSteady() const {return false;}
 	};
 }
 
@@ -3,6 +3,8 @@
 
 #include "State.hpp"
 
+#include <array>
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -29,6 +31,8 @@ namespace SuperHaxagon {
 		void enter() override;
 		void drawTop(float scale) override;
 		void drawBot(float scale) override;
+		const char* getName() const override {return "Win";}
+		const Level* getLevel() const override {return _level.get();}
 
 	private:
 		Game& _game;
@@ -46,6 +50,14 @@ namespace SuperHaxagon {
 		float _timer = 0.0;
 
 		std::string _text = "GAME OVER";
+
+		std::array<uint64_t, 7> _eventLevels{};
+		uint64_t _eventHyper;
+		uint64_t _eventSurround;
+		uint64_t _eventPulseLarge;
+		uint64_t _eventPulseSmall;
+		uint64_t _eventInvert;
+		uint64_t _eventCredits;
 	};
 }
 
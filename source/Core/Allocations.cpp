@@ -0,0 +1,32 @@
+#include "Core/Allocations.hpp"
+
+#ifdef SUPER_HAXAGON_ALLOC_TRACK
+#include <cstdlib>
+#include <new>
+
+namespace SuperHaxagon {
+	// Plain old data, so touching it can never allocate in turn
+	static thread_local Allocations::Count counted{0, 0};
+
+	Allocations::Count Allocations::get() {
+		return counted;
+	}
+}
+
+// The array and nothrow forms all end up in here. Over-aligned types are
+// left to the library, and nothing in the game uses them.
+void* operator new(const std::size_t size) {
+	SuperHaxagon::counted.allocs++;
+	SuperHaxagon::counted.bytes += size;
+	if (auto* memory = std::malloc(size ? size : 1)) return memory;
+	throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+	std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+	std::free(memory);
+}
+#endif
@@ -0,0 +1,124 @@
+#include "Core/AssetCache.hpp"
+
+#include "Core/AudioLoader.hpp"
+#include "Core/Metadata.hpp"
+#include "Core/Platform.hpp"
+
+#include <istream>
+#include <utility>
+
+namespace SuperHaxagon {
+	static std::string makeKey(const char kind, const std::string& base, const Location location) {
+		return std::string(1, kind) + std::to_string(static_cast<int>(location)) + base;
+	}
+
+	AssetCache::AssetCache(Platform& platform, const size_t budget) :
+		_platform(platform),
+		_budget(budget) {}
+
+	AssetCache::~AssetCache() = default;
+
+	std::shared_ptr<AudioLoader> AssetCache::getAudio(const std::string& base, const Location location) {
+		const auto key = makeKey('A', base, location);
+		{
+#ifndef SUPER_HAXAGON_NO_THREADS
+			std::lock_guard<std::mutex> lock(_mutex);
+#endif
+			const auto* entry = find(key);
+			if (entry) return entry->audio;
+		}
+
+		// Opening can take a while, so nothing waits on the lock for it.
+		// Failures are not cached, so the next try opens it again.
+		std::shared_ptr<AudioLoader> audio = _platform.loadAudio(base, Stream::INDIRECT, location);
+		if (!audio) return nullptr;
+
+		// Too big for what is left is the same as not being there
+		auto charge = _platform.getMemory().reserve(MemoryTag::AUDIO, audio->getSize(), "bgm " + base);
+		if (!charge) return nullptr;
+		audio->setCharge(std::move(charge));
+
+#ifndef SUPER_HAXAGON_NO_THREADS
+		std::lock_guard<std::mutex> lock(_mutex);
+#endif
+		insert({key, audio, nullptr, audio->getSize()});
+		return audio;
+	}
+
+	std::unique_ptr<Metadata> AssetCache::getMetadata(const std::string& base, const Location location) {
+		// The cached one is never advanced, so copies always start at the beginning
+		const auto metadata = loadMetadata(base, location);
+		return std::make_unique<Metadata>(*metadata);
+	}
+
+	void AssetCache::prefetch(const std::string& base, const Location location) {
+		getAudio(base, location);
+		loadMetadata(base, location);
+	}
+
+	void AssetCache::setBudget(const size_t budget) {
+#ifndef SUPER_HAXAGON_NO_THREADS
+		std::lock_guard<std::mutex> lock(_mutex);
+#endif
+		_budget = budget;
+		trim();
+	}
+
+	size_t AssetCache::getSize() const {
+#ifndef SUPER_HAXAGON_NO_THREADS
+		std::lock_guard<std::mutex> lock(_mutex);
+#endif
+		return _size;
+	}
+
+	std::shared_ptr<const Metadata> AssetCache::loadMetadata(const std::string& base, const Location location) {
+		const auto key = makeKey('M', base, location);
+		{
+#ifndef SUPER_HAXAGON_NO_THREADS
+			std::lock_guard<std::mutex> lock(_mutex);
+#endif
+			const auto* entry = find(key);
+			if (entry) return entry->metadata;
+		}
+
+		// A song with no timeline is cached too, so it is not looked for every time
+		std::shared_ptr<const Metadata> metadata = std::make_shared<Metadata>(_platform.openFile(base + ".txt", location));
+
+#ifndef SUPER_HAXAGON_NO_THREADS
+		std::lock_guard<std::mutex> lock(_mutex);
+#endif
+		insert({key, nullptr, metadata, metadata->getSize()});
+		return metadata;
+	}
+
+	AssetCache::Entry* AssetCache::find(const std::string& key) {
+		const auto it = _index.find(key);
+		if (it == _index.end()) return nullptr;
+
+		// Used again, so it goes to the front of the line
+		_entries.splice(_entries.begin(), _entries, it->second);
+		return &_entries.front();
+	}
+
+	void AssetCache::insert(Entry entry) {
+		// Someone else may have loaded it in the meantime
+		if (find(entry.key)) return;
+
+		// Bookkeeping, so even entries that report no size count for something
+		entry.size += sizeof(Entry) + entry.key.size();
+		_size += entry.size;
+		_entries.push_front(std::move(entry));
+		_index[_entries.front().key] = _entries.begin();
+		trim();
+	}
+
+	void AssetCache::trim() {
+		// The newest entry stays, even if it is over the budget on its own
+		while (_size > _budget && _entries.size() > 1) {
+			const auto& oldest = _entries.back();
+			_size -= oldest.size;
+			_index.erase(oldest.key);
+			_entries.pop_back();
+		}
+	}
+}
@@ -0,0 +1,74 @@
+#include "Core/AudioSink.hpp"
+
+#ifndef SUPER_HAXAGON_NO_THREADS
+
+#include "Core/Mixer.hpp"
+#include "Core/Sound.hpp"
+
+#include <chrono>
+
+namespace SuperHaxagon {
+	AudioSink::AudioSink(Mixer& mixer) :
+		_mixer(mixer),
+		_period(PERIOD_FRAMES * Mixer::CHANNELS) {}
+
+	AudioSink::~AudioSink() {
+		stop();
+	}
+
+	void AudioSink::start() {
+		_running.store(true, std::memory_order_release);
+		_thread = std::thread([this] {
+			const std::chrono::duration<double> period(static_cast<double>(PERIOD_FRAMES) / _mixer.getRate());
+			auto next = std::chrono::steady_clock::now();
+			while (_running.load(std::memory_order_acquire)) {
+				_mixer.pull(_period.data(), PERIOD_FRAMES);
+				consume(_period.data(), PERIOD_FRAMES);
+				_frames.store(_frames.load(std::memory_order_relaxed) + PERIOD_FRAMES, std::memory_order_relaxed);
+
+				next += std::chrono::duration_cast<std::chrono::steady_clock::duration>(period);
+				std::this_thread::sleep_until(next);
+			}
+		});
+	}
+
+	void AudioSink::stop() {
+		if (!_thread.joinable()) return;
+		_running.store(false, std::memory_order_release);
+		_thread.join();
+	}
+
+	NullSink::NullSink(Mixer& mixer) : AudioSink(mixer) {
+		start();
+	}
+
+	NullSink::~NullSink() {
+		stop();
+	}
+
+	WavSink::WavSink(Mixer& mixer, const std::string& path) :
+		AudioSink(mixer),
+		_file(path, std::ios::out | std::ios::binary | std::ios::trunc) {
+		if (!_file) return;
+
+		// Placeholder until the length is known
+		writeWavHeader(_file, _mixer.getRate(), Mixer::CHANNELS, 0);
+		start();
+	}
+
+	WavSink::~WavSink() {
+		stop();
+		if (!_file) return;
+
+		_file.seekp(0);
+		writeWavHeader(_file, _mixer.getRate(), Mixer::CHANNELS, _written);
+	}
+
+	void WavSink::consume(const int16_t* samples, const size_t frames) {
+		// WAV files are little endian, like everything this runs on
+		_file.write(reinterpret_cast<const char*>(samples), static_cast<std::streamsize>(frames * Mixer::CHANNELS * sizeof(int16_t)));
+		_written += static_cast<uint32_t>(frames);
+	}
+}
+
+#endif
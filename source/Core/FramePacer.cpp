@@ -0,0 +1,66 @@
+#include "Core/FramePacer.hpp"
+
+#include <algorithm>
+
+namespace SuperHaxagon {
+	static float seconds(const FramePacer::Clock::duration duration) {
+		return std::chrono::duration<float>(duration).count();
+	}
+
+	void FramePacer::reset() {
+		_state = State::CALIBRATING;
+		_samples = 0;
+		_misses = 0;
+		_work = 0;
+	}
+
+	void FramePacer::begin(const Clock::time_point now) {
+		_begin = now;
+	}
+
+	bool FramePacer::presented(const Clock::time_point before, const Clock::time_point after) {
+		const auto first = _presented == Clock::time_point{};
+		const auto interval = seconds(after - _presented);
+		_latency = seconds(after - _begin);
+		_presented = after;
+		if (first) return false;
+
+		// The slowest recent frame, so one that runs long does not miss
+		_work = std::max(seconds(before - _begin), _work * WORK_DECAY);
+
+		switch (_state) {
+		case State::CALIBRATING: {
+			_intervals[_samples++] = interval;
+			if (_samples < CALIBRATE_FRAMES) return false;
+
+			// The median, so a hitch while learning does not count
+			const auto middle = _intervals.begin() + CALIBRATE_FRAMES / 2;
+			std::nth_element(_intervals.begin(), middle, _intervals.end());
+			_period = *middle;
+			_state = _period < MIN_PERIOD || _period > MAX_PERIOD ? State::OFF : State::PACING;
+			_misses = 0;
+			return true;
+		}
+
+		case State::PACING:
+			// Presents land one period apart, anything else is a frame
+			// that missed or a display that changed
+			if (interval > _period * 1.5f || interval < _period * 0.75f) _misses++;
+			else _misses = 0;
+
+			if (_misses < RECALIBRATE_MISSES) return false;
+			reset();
+			return true;
+
+		case State::OFF:
+			break;
+		}
+
+		return false;
+	}
+
+	FramePacer::Clock::time_point FramePacer::getWake() const {
+		const std::chrono::duration<float> wait(_period - _work - MARGIN);
+		return _presented + std::chrono::duration_cast<Clock::duration>(wait);
+	}
+}
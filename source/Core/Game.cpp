@@ -1,16 +1,41 @@
 #include "Core/Game.hpp"
 
+#include "Core/AssetCache.hpp"
 #include "Core/Metadata.hpp"
 #include "Core/Twist.hpp"
 #include "Core/Font.hpp"
+#include "Core/History.hpp"
+#include "Core/Jobs.hpp"
+#include "Core/Overlay.hpp"
 #include "Core/Platform.hpp"
+#include "Core/QualityGovernor.hpp"
+#include "Core/Scores.hpp"
+#include "Core/Structs.hpp"
+#include "Core/Trace.hpp"
+#include "Core/Worker.hpp"
 #include "Factories/LevelFactory.hpp"
 #include "Factories/PatternFactory.hpp"
 #include "States/Load.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cmath>
+#include <cstring>
+#include <fstream>
 
 namespace SuperHaxagon {
+	const char* Game::LATENCY_HEADER = "LTNC1.0";
+	const char* Game::LATENCY_FOOTER = "ENDLTNC";
+
+	// Filled in by the worker, then picked up on the game thread once ready is set
+	struct Game::PendingBGM {
+		std::shared_ptr<AudioLoader> audio;
+		std::unique_ptr<Metadata> metadata;
+		std::unique_ptr<AudioPlayer> player;
+		bool crossfade = false;
+		std::atomic<bool> ready{false};
+	};
 
 	Game::Game(Platform& platform) : _platform(platform) {
 		// Audio loading
@@ -21,41 +46,145 @@ namespace SuperHaxagon {
 		_sfxLevelUp = platform.loadAudio("/sound/level", Stream::DIRECT, Location::ROM);
 		_sfxWonderful = platform.loadAudio("/sound/wonderful", Stream::DIRECT, Location::ROM);
 
+		// Menu blips give way to anything about the run itself
+		_sfxBegin->setPriority(1);
+		_sfxLevelUp->setPriority(1);
+		_sfxWonderful->setPriority(1);
+		_sfxOver->setPriority(2);
+
 		_small = platform.loadFont("/bump-it-up", 16);
 		_large = platform.loadFont("/bump-it-up", 32);
 
+		// The game cannot go without these, so they are only counted
+		auto& memory = platform.getMemory();
+		for (auto* sfx : {_sfxBegin.get(), _sfxHexagon.get(), _sfxOver.get(), _sfxSelect.get(), _sfxLevelUp.get(), _sfxWonderful.get()}) {
+			sfx->setCharge(memory.charge(MemoryTag::AUDIO, sfx->getSize()));
+		}
+
+		_small->setCharge(memory.charge(MemoryTag::FONTS, _small->getSize()));
+		_large->setCharge(memory.charge(MemoryTag::FONTS, _large->getSize()));
+
 		_twister = platform.getTwister();
+		_scores = std::make_unique<Scores>(*this);
+		_history = std::make_unique<History>(*this);
+		_cache = std::make_unique<AssetCache>(platform);
+		_worker = std::make_unique<Worker>();
+		_jobs = std::make_unique<Jobs>(platform.getCores());
+		_quality = std::make_unique<QualityGovernor>(platform);
+		_overlay = std::make_unique<Overlay>(*this);
 	}
 
 	Game::~Game() {
+		// Write out anything still held in memory before leaving
+		_scores->compact();
+		_history->save();
+		_scores = nullptr;
+		_history = nullptr;
+		_worker = nullptr;
+		_jobs = nullptr;
+		_bgmPending = nullptr;
+		_bgmFading = nullptr;
+		_sfxDelayedCount = 0;
 		_platform.stopBGM();
+		_platform.getMemory().report();
 		_platform.message(SuperHaxagon::Dbg::INFO, "game", "shutdown ok");
 	}
 
 	void Game::run() {
+		auto& trace = _platform.getProfiler().getTrace();
+		auto& metrics = _platform.getMetrics();
 		_state = std::make_unique<Load>(*this);
 		_state->enter();
 		while(_running && _platform.loop()) {
+			SUPER_HAXAGON_FRAME(_platform.getProfiler());
+#ifdef SUPER_HAXAGON_ALLOC_TRACK
+			checkAllocations();
+#endif
+
 			// The original game was built with a 3DS in mind, so when
 			// drawing we have to scale the game to however many times larger the viewport is.
 			const auto scale = getScreenDimMin() / 240.0f;
 			const auto dilation = _platform.getDilation();
-
-			auto next = _state->update(dilation);
-			if (!_running) break;
-			while (next) {
-				_state->exit();
-				_state = std::move(next);
-				_state->enter();
-				next = _state->update(dilation);
+			const auto start = std::chrono::steady_clock::now();
+			metrics.frame(dilation);
+			metrics.setUnderruns(_platform.getAudioUnderruns());
+			updateBGM(dilation);
+			updateSFX(dilation);
+
+#ifdef SUPER_HAXAGON_PROFILE
+			// Toggled on the press, so holding the button does not flicker it
+			const auto overlay = _platform.getPressed().overlay;
+			if (overlay && !_overlayHeld) toggleOverlay();
+			_overlayHeld = overlay;
+#endif
+
+			{
+				SUPER_HAXAGON_ZONE(_platform.getProfiler(), Zone::UPDATE);
+				auto next = _state->update(dilation);
+				if (!_running) break;
+				while (next) {
+					_state->exit();
+					_state = std::move(next);
+					_stateFrames = 0;
+					_quality->settle();
+					SUPER_HAXAGON_INSTANT(trace, Trace::Track::GAME, "state", _state->getName());
+					_state->enter();
+					next = _state->update(dilation);
+				}
 			}
 
 			_platform.screenBegin();
-			_state->drawTop(scale);
+			{
+				SUPER_HAXAGON_ZONE(_platform.getProfiler(), Zone::DRAW_TOP);
+				_state->drawTop(scale);
+			}
+
 			_platform.screenSwap();
-			_state->drawBot(scale);
+			{
+				SUPER_HAXAGON_ZONE(_platform.getProfiler(), Zone::DRAW_BOT);
+				_state->drawBot(scale);
+				if (_overlayShown) _overlay->draw(scale, _state->getLevel());
+			}
+
+			// Waiting on the display does not count as work, and the quality
+			// only changes once the frame is out, as it can remake the window
+			const auto work = std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count();
 			_platform.screenFinalize();
+			_quality->frame(dilation * QualityGovernor::BUDGET, work);
+		}
+	}
+
+	void Game::toggleOverlay() {
+		auto& trace = _platform.getProfiler().getTrace();
+		_overlayShown = !_overlayShown;
+		_platform.setOverlay(_overlayShown);
+		if (_overlayShown) {
+			trace.start();
+			return;
 		}
+
+		// Everything from while the overlay was up, for a trace viewer
+		auto events = std::make_shared<std::vector<Trace::Event>>(trace.stop());
+		if (events->empty() || !static_cast<int>(_platform.supports() & Supports::FILESYSTEM)) return;
+
+		const auto path = _platform.getPath("/trace.json", Location::USER);
+		if (_platform.isLogged(Dbg::INFO)) _platform.message(Dbg::INFO, "trace", "writing " + std::to_string(events->size()) + " events to " + path);
+		_worker->push([path, events] {
+			std::ofstream stream(path, std::ios::out | std::ios::trunc);
+			if (stream) Trace::write(stream, *events);
+		});
+	}
+
+	void Game::checkAllocations() {
+		// The frame that just finished, so the state has already had it
+		if (!_state || !_state->isSteady() || ++_stateFrames <= STEADY_FRAMES) return;
+
+		auto& profiler = _platform.getProfiler();
+		const auto* frame = profiler.getFrame(0);
+		if (!frame || !frame->allocs) return;
+
+		_steadyAllocations++;
+		profiler.reportAllocations(*frame);
 	}
 
 	void Game::addLevel(std::unique_ptr<LevelFactory> level) {
@@ -81,6 +210,12 @@ namespace SuperHaxagon {
 		//solid background.
 		const Point position = {0,0};
 		const auto size = _platform.getScreenDim();
+		if (!_quality->hasSlices()) {
+			// Halfway between, so the screen keeps roughly the same shade
+			drawRect(interpolateColor(color1, color2, 0.5f), position, size);
+			return;
+		}
+
 		drawRect(color1, position, size);
 
 		//This draws the main background.
@@ -147,18 +282,59 @@ namespace SuperHaxagon {
 		_platform.drawPoly(color, triangle);
 	}
 
+	static bool isWallShown(const Wall& wall, const float sides, const float offset) {
+		const auto distance = wall.getDistance() + offset;
+		if(distance + wall.getHeight() < SCALE_HEX_LENGTH) return false; //TOO_CLOSE;
+		if(static_cast<float>(wall.getSide()) >= sides) return false; //NOT_IN_RANGE
+		return true;
+	}
+
 	void Game::drawPatterns(const Color& color, const Point& focus, const std::deque<Pattern>& patterns, const float rotation, const float sides, const float offset, const float scale) const {
+		size_t walls = 0;
+		for(const auto& pattern : patterns) walls += pattern.getWalls().size();
+
+		if (walls < PARALLEL_WALLS || _jobs->getThreads() == 1) {
+			for(const auto& pattern : patterns) {
+				for(const auto& wall : pattern.getWalls()) {
+					drawWalls(color, focus, wall, rotation, sides, offset, scale);
+				}
+			}
+
+			return;
+		}
+
+		// Only the geometry is split up, platforms draw from one thread
+		_drawWalls.clear();
 		for(const auto& pattern : patterns) {
-			for(const auto& wall : pattern.getWalls()) {
-				drawWalls(color, focus, wall, rotation, sides, offset, scale);
+			for(const auto& wall : pattern.getWalls()) _drawWalls.push_back(&wall);
+		}
+
+		if (_drawQuads.size() < walls) _drawQuads.resize(walls);
+
+		// Captures little enough that making the job does not allocate
+		const struct {Point focus; float rotation, sides, offset, scale;} args{focus, rotation, sides, offset, scale};
+		_jobs->parallelFor(walls, WALL_GRAIN, [this, &args](const size_t begin, const size_t end) {
+			for (auto i = begin; i < end; i++) {
+				const auto& wall = *_drawWalls[i];
+				auto& quad = _drawQuads[i];
+				if (isWallShown(wall, args.sides, args.offset)) {
+					wall.calcPoints(quad, args.focus, args.rotation, args.sides, args.offset, args.scale);
+				} else {
+					quad.clear();
+				}
 			}
+		});
+
+		for (size_t i = 0; i < walls; i++) {
+			auto& quad = _drawQuads[i];
+			if (quad.empty()) continue;
+			skew(quad);
+			_platform.drawPoly(color, quad);
 		}
 	}
 
 	void Game::drawWalls(const Color& color, const Point& focus, const Wall& wall, const float rotation, const float sides, const float offset, const float scale) const {
-		const auto distance = wall.getDistance() + offset;
-		if(distance + wall.getHeight() < SCALE_HEX_LENGTH) return; //TOO_CLOSE;
-		if(static_cast<float>(wall.getSide()) >= sides) return; //NOT_IN_RANGE
+		if(!isWallShown(wall, sides, offset)) return;
 		auto trap = wall.calcPoints(focus, rotation, sides, offset, scale);
 
 		skew(trap);
@@ -204,14 +380,152 @@ namespace SuperHaxagon {
 		return std::min(size.x, size.y);
 	}
 
-	void Game::loadBGMAudio(const std::string& music, const Location location, const bool loadMetadata) {
+	void Game::loadBGMAudio(const std::string& music, const Location location, const bool loadMetadata, const bool crossfade) {
 		const auto base = "/bgm" + music;
 
-		if (loadMetadata) {
-			_bgmMetadata = std::make_unique<Metadata>(_platform.openFile(base + ".txt", location));
+		// Anything still loading from an earlier request is thrown away when it finishes
+		auto pending = std::make_shared<PendingBGM>();
+		pending->crossfade = crossfade;
+		_bgmPending = pending;
+
+		// Opening the file and priming the decoder happen off the game thread
+		auto* cache = _cache.get();
+		auto* trace = &_platform.getProfiler().getTrace();
+		auto* loads = &_platform.getMetrics().getBGMLoads();
+		_worker->push([cache, trace, loads, pending, base, location, loadMetadata] {
+			SUPER_HAXAGON_SPAN(*trace, Trace::Track::WORKER, "load bgm", base);
+			const auto start = std::chrono::steady_clock::now();
+			if (loadMetadata) pending->metadata = cache->getMetadata(base, location);
+			pending->audio = cache->getAudio(base, location);
+			if (pending->audio) pending->player = pending->audio->instantiate();
+			loads->observe(std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count());
+			pending->ready.store(true, std::memory_order_release);
+		});
+	}
+
+	void Game::prefetchBGM(const std::string& music, const Location location) {
+#ifdef SUPER_HAXAGON_NO_THREADS
+		// The worker would load it right here, stalling the menu for nothing
+		static_cast<void>(music);
+		static_cast<void>(location);
+#else
+		// Shares the worker with real loads, which only wait on the few queued ahead of them
+		const auto base = "/bgm" + music;
+		auto* cache = _cache.get();
+		auto* trace = &_platform.getProfiler().getTrace();
+		_worker->push([cache, trace, base, location] {
+			SUPER_HAXAGON_SPAN(*trace, Trace::Track::WORKER, "prefetch bgm", base);
+			cache->prefetch(base, location);
+		});
+#endif
+	}
+
+	bool Game::isBGMLoading() {
+		if (!_bgmPending) return false;
+		if (!_bgmPending->ready.load(std::memory_order_acquire)) return true;
+
+		const auto pending = std::move(_bgmPending);
+		if (pending->metadata) _bgmMetadata = std::move(pending->metadata);
+
+		const auto* current = _platform.getBGM();
+		const auto crossfade = pending->crossfade && pending->player && current && !current->isDone();
+		if (crossfade) pending->player->setVolume(0.0f);
+
+		// A fade that is still going is cut short by the new one
+		_bgmFading = nullptr;
+		_bgmFadingAudio = nullptr;
+
+		auto old = _platform.swapBGM(std::move(pending->player));
+		auto oldAudio = std::move(_bgmAudio);
+		_bgmAudio = std::move(pending->audio);
+		if (crossfade && old) {
+			_bgmFading = std::move(old);
+			_bgmFadingAudio = std::move(oldAudio);
+			_bgmFade = 0.0f;
+		}
+
+		// Players can use their loader, so they have to go first
+		old = nullptr;
+		oldAudio = nullptr;
+		return false;
+	}
+
+	void Game::updateBGM(const float dilation) {
+		isBGMLoading();
+		if (!_bgmFading) return;
+
+		// Equal power, so the mix does not dip in the middle
+		_bgmFade += dilation;
+		const auto percent = std::min(1.0f, _bgmFade / BGM_FADE_FRAMES);
+		auto* bgm = _platform.getBGM();
+		if (bgm) bgm->setVolume(std::sqrt(percent));
+		_bgmFading->setVolume(std::sqrt(1.0f - percent));
+		if (percent < 1.0f) return;
+
+		_bgmFading = nullptr;
+		_bgmFadingAudio = nullptr;
+	}
+
+	void Game::playSFX(AudioLoader& audio) {
+		// Early is better than never when too many are already waiting
+		if (_latency <= 0.0f || _sfxDelayedCount == MAX_DELAYED_SFX) {
+			_platform.playSFX(audio);
+			return;
 		}
-		
-		_bgmAudio = _platform.loadAudio(base, Stream::INDIRECT, location);
-		_platform.playBGM(*getBGMAudio());
+
+		// The game runs at 60 frames a second as far as dilation is concerned
+		_sfxDelayed[_sfxDelayedCount++] = {&audio, _latency * 60.0f};
+	}
+
+	void Game::updateSFX(const float dilation) {
+		for (size_t i = 0; i < _sfxDelayedCount;) {
+			auto& delayed = _sfxDelayed[i];
+			delayed.second -= dilation;
+			if (delayed.second > 0.0f) {
+				i++;
+				continue;
+			}
+
+			// Swapped with the last, as the order they wait in does not matter
+			_platform.playSFX(*delayed.first);
+			delayed = _sfxDelayed[--_sfxDelayedCount];
+		}
+	}
+
+	void Game::loadLatency() {
+		std::ifstream stream(_platform.getPath("/latency", Location::USER), std::ios::in | std::ios::binary);
+		if (!stream) {
+			_platform.message(Dbg::INFO, "latency", "not calibrated");
+			return;
+		}
+
+		if (!readCompare(stream, LATENCY_HEADER)) {
+			_platform.message(Dbg::WARN, "latency", "header invalid, skipping calibration");
+			return;
+		}
+
+		const auto limit = static_cast<int32_t>(MAX_LATENCY * 1000000.0f);
+		const auto micros = read32(stream, -limit, limit, _platform, "latency");
+		if (!readCompare(stream, LATENCY_FOOTER)) {
+			_platform.message(Dbg::WARN, "latency", "footer invalid, skipping calibration");
+			return;
+		}
+
+		_latency = static_cast<float>(micros) / 1000000.0f;
+	}
+
+	void Game::setLatency(const float latency) {
+		_latency = std::min(std::max(latency, -MAX_LATENCY), MAX_LATENCY);
+		if (!static_cast<int>(_platform.supports() & Supports::FILESYSTEM)) return;
+
+		const auto micros = static_cast<int32_t>(std::lround(_latency * 1000000.0f));
+		auto path = _platform.getPath("/latency", Location::USER);
+		_worker->push([path, micros] {
+			std::ofstream stream(path, std::ios::out | std::ios::binary | std::ios::trunc);
+			if (!stream) return;
+			stream.write(LATENCY_HEADER, strlen(LATENCY_HEADER));
+			stream.write(reinterpret_cast<const char*>(&micros), sizeof(micros));
+			stream.write(LATENCY_FOOTER, strlen(LATENCY_FOOTER));
+		});
 	}
 }
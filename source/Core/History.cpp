@@ -0,0 +1,147 @@
+#include "Core/History.hpp"
+
+#include "Core/Game.hpp"
+#include "Core/Platform.hpp"
+#include "Core/Structs.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+namespace SuperHaxagon {
+	const char* History::BLOCK_HEADER = "RUNB";
+
+	void RunStats::add(const float duration) {
+		attempts++;
+		total += duration;
+		if (duration > best) best = duration;
+
+		const auto bucket = static_cast<int>(duration / BUCKET_FRAMES);
+		histogram[std::min(std::max(bucket, 0), BUCKETS - 1)]++;
+	}
+
+	float RunStats::getAverage() const {
+		return attempts ? static_cast<float>(total / attempts) : 0.0f;
+	}
+
+	float RunStats::getPercentile(const float percent) const {
+		const auto target = static_cast<uint32_t>(std::ceil(attempts * percent / 100.0f));
+		uint32_t seen = 0;
+		for (auto i = 0; i < BUCKETS; i++) {
+			seen += histogram[i];
+			if (seen >= target && seen > 0) return std::min(static_cast<float>(i + 1) * BUCKET_FRAMES, best);
+		}
+
+		return best;
+	}
+
+	History::History(Game& game) :
+		_platform(game.getPlatform()),
+		_path(_platform.getPath("/history.log", Location::USER)) {
+		_pending.reserve(BLOCK_RUNS);
+
+		// Queued ahead of any writes, so it reads only what came before
+		_worker.push([this] {scan();});
+	}
+
+	History::~History() = default;
+
+	void History::record(const Run& run) {
+		_pending.push_back(run);
+
+		// Keep the stats up to date instead of reading it all again
+		if (adopt()) _cache[run.level].add(run.duration);
+		else _early.push_back(run);
+
+		if (_pending.size() >= BLOCK_RUNS) save();
+	}
+
+	const RunStats& History::getStats(const uint64_t id) {
+		static const RunStats empty;
+		if (!adopt()) return empty;
+		const auto it = _cache.find(id);
+		return it != _cache.end() ? it->second : empty;
+	}
+
+	bool History::adopt() {
+		if (_adopted) return true;
+		if (!_ready.load(std::memory_order_acquire)) return false;
+
+		_cache = std::move(_scanned);
+		for (const auto& run : _early) _cache[run.level].add(run.duration);
+		_early.clear();
+		_early.shrink_to_fit();
+		_adopted = true;
+		return true;
+	}
+
+	void History::save() {
+		if (_pending.empty()) return;
+
+		// Lay the runs out column by column
+		const auto count = static_cast<uint32_t>(_pending.size());
+		std::string block(strlen(BLOCK_HEADER) + sizeof(count) + count * RUN_SIZE, '\0');
+		auto* out = &block[0];
+		const auto put = [&out](const void* value, const size_t size) {
+			std::memcpy(out, value, size);
+			out += size;
+		};
+
+		put(BLOCK_HEADER, strlen(BLOCK_HEADER));
+		put(&count, sizeof(count));
+		for (const auto& run : _pending) put(&run.level, sizeof(run.level));
+		for (const auto& run : _pending) put(&run.duration, sizeof(run.duration));
+		for (const auto& run : _pending) put(&run.seed, sizeof(run.seed));
+		for (const auto& run : _pending) put(&run.deathFrame, sizeof(run.deathFrame));
+		for (const auto& run : _pending) put(&run.frameTime, sizeof(run.frameTime));
+		for (const auto& run : _pending) put(&run.cause, sizeof(run.cause));
+		_pending.clear();
+
+		auto path = _path;
+		_worker.push([path, block] {
+			std::ofstream log(path, std::ios::out | std::ios::binary | std::ios::app);
+			if (!log) return;
+			log.write(block.data(), block.size());
+		});
+	}
+
+	void History::scan() {
+		std::ifstream log(_path, std::ios::in | std::ios::binary | std::ios::ate);
+		const auto size = log ? static_cast<std::streamoff>(log.tellg()) : 0;
+		log.seekg(0);
+
+		std::vector<uint64_t> levels;
+		std::vector<float> durations;
+		std::unordered_map<uint64_t, RunStats> stats;
+		auto damaged = false;
+		while (log && log.tellg() < size) {
+			// A crash while appending leaves a short block at the end
+			damaged = true;
+			uint32_t count = 0;
+			if (!readCompare(log, BLOCK_HEADER)) break;
+			log.read(reinterpret_cast<char*>(&count), sizeof(count));
+			if (!log || count == 0 || count > BLOCK_RUNS) break;
+
+			const auto start = static_cast<std::streamoff>(log.tellg());
+			const auto end = start + static_cast<std::streamoff>(count * RUN_SIZE);
+			if (end > size) break;
+
+			// Only the first two columns are needed
+			levels.resize(count);
+			durations.resize(count);
+			log.read(reinterpret_cast<char*>(levels.data()), count * sizeof(uint64_t));
+			log.read(reinterpret_cast<char*>(durations.data()), count * sizeof(float));
+			if (!log) break;
+			for (uint32_t i = 0; i < count; i++) stats[levels[i]].add(durations[i]);
+
+			log.seekg(end);
+			damaged = false;
+		}
+
+		if (damaged) _platform.message(Dbg::WARN, "history", "history has a damaged block, ignoring the rest");
+
+		_scanned = std::move(stats);
+		_ready.store(true, std::memory_order_release);
+	}
+}
@@ -0,0 +1,165 @@
+#include "Core/Jobs.hpp"
+
+#include <algorithm>
+
+namespace SuperHaxagon {
+#ifdef SUPER_HAXAGON_NO_THREADS
+	Jobs::Jobs(size_t) {}
+	Jobs::~Jobs() = default;
+
+	void Jobs::parallelFor(const size_t count, size_t, const Body& body) {
+		// No threads, so the caller does it all
+		if (count > 0) body(0, count);
+	}
+
+	size_t Jobs::getThreads() const {
+		return 1;
+	}
+#else
+	struct Jobs::Batch {
+		const Body* body;
+		std::atomic<size_t> remaining;
+	};
+
+	Jobs::Jobs(size_t threads) {
+		threads = std::max<size_t>(threads, 1);
+		for (size_t i = 0; i < threads; i++) _queues.emplace_back(std::make_unique<Queue>());
+		for (size_t i = 0; i + 1 < threads; i++) _threads.emplace_back(&Jobs::run, this, i);
+	}
+
+	Jobs::~Jobs() {
+		{
+			std::lock_guard<std::mutex> lock(_sleep);
+			_quit = true;
+		}
+
+		_wake.notify_all();
+		for (auto& thread : _threads) thread.join();
+	}
+
+	void Jobs::parallelFor(const size_t count, size_t grain, const Body& body) {
+		if (count == 0) return;
+		grain = std::max<size_t>(grain, 1);
+		if (_threads.empty() || count <= grain) {
+			body(0, count);
+			return;
+		}
+
+		const auto chunks = (count + grain - 1) / grain;
+		Batch batch{&body, {chunks}};
+
+		// Counted first, so taking a task can never take it below zero
+		_queued.fetch_add(chunks, std::memory_order_release);
+
+		// Neighbouring chunks go to the same queue, so a thread that is
+		// never stolen from works through memory in order
+		const auto queues = _queues.size();
+		for (size_t q = 0; q < queues; q++) {
+			const auto first = chunks * q / queues;
+			const auto last = chunks * (q + 1) / queues;
+			if (first == last) continue;
+
+			std::lock_guard<std::mutex> lock(_queues[q]->mutex);
+			for (auto chunk = first; chunk < last; chunk++) {
+				_queues[q]->pushBack({&batch, chunk * grain, std::min(count, (chunk + 1) * grain)});
+			}
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(_sleep);
+		}
+
+		_wake.notify_all();
+
+		// Help out until the batch is done. The tasks picked up here may
+		// belong to someone else's batch, which is just as good.
+		const auto caller = queues - 1;
+		while (batch.remaining.load(std::memory_order_acquire) > 0) {
+			Task task{};
+			if (take(caller, task)) {
+				runTask(task);
+				continue;
+			}
+
+			std::unique_lock<std::mutex> lock(_sleep);
+			_wake.wait(lock, [this, &batch] {
+				return batch.remaining.load(std::memory_order_acquire) == 0 || _queued.load(std::memory_order_acquire) > 0;
+			});
+		}
+	}
+
+	size_t Jobs::getThreads() const {
+		return _queues.size();
+	}
+
+	bool Jobs::take(const size_t queue, Task& task) {
+		const auto queues = _queues.size();
+		for (size_t i = 0; i < queues; i++) {
+			auto& victim = *_queues[(queue + i) % queues];
+			std::lock_guard<std::mutex> lock(victim.mutex);
+			if (victim.size == 0) continue;
+
+			// Our own work comes off the back, stolen work off the front
+			task = i == 0 ? victim.popBack() : victim.popFront();
+
+			_queued.fetch_sub(1, std::memory_order_relaxed);
+			return true;
+		}
+
+		return false;
+	}
+
+	void Jobs::Queue::pushBack(const Task& task) {
+		const auto mask = tasks.size() - 1;
+		if (size == tasks.size()) {
+			// Full, so double it, unwrapping the tasks to the start
+			std::vector<Task> grown(tasks.size() * 2);
+			for (size_t i = 0; i < size; i++) grown[i] = tasks[(first + i) & mask];
+			tasks = std::move(grown);
+			first = 0;
+		}
+
+		tasks[(first + size) & (tasks.size() - 1)] = task;
+		size++;
+	}
+
+	Jobs::Task Jobs::Queue::popBack() {
+		size--;
+		return tasks[(first + size) & (tasks.size() - 1)];
+	}
+
+	Jobs::Task Jobs::Queue::popFront() {
+		const auto task = tasks[first];
+		first = (first + 1) & (tasks.size() - 1);
+		size--;
+		return task;
+	}
+
+	void Jobs::runTask(const Task& task) {
+		(*task.batch->body)(task.begin, task.end);
+
+		// The batch can be gone as soon as the count reaches zero
+		if (task.batch->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+			{
+				std::lock_guard<std::mutex> lock(_sleep);
+			}
+
+			_wake.notify_all();
+		}
+	}
+
+	void Jobs::run(const size_t queue) {
+		while (true) {
+			Task task{};
+			if (take(queue, task)) {
+				runTask(task);
+				continue;
+			}
+
+			std::unique_lock<std::mutex> lock(_sleep);
+			_wake.wait(lock, [this] {return _quit || _queued.load(std::memory_order_acquire) > 0;});
+			if (_quit && _queued.load(std::memory_order_acquire) == 0) return;
+		}
+	}
+#endif
+}
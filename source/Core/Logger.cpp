@@ -0,0 +1,140 @@
+#include "Core/Logger.hpp"
+
+#include "Core/Platform.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace SuperHaxagon {
+	struct Logger::Entry {
+		std::atomic<size_t> sequence; // Which lap of the ring it is ready for, see push()
+		Dbg level;
+		char where[WHERE];
+		char text[TEXT];
+	};
+
+	Logger::Logger(Platform& platform) : _platform(platform), _level(static_cast<int>(Dbg::INFO)) {}
+
+	Logger::~Logger() {
+		stop();
+	}
+
+	void Logger::setLevel(const Dbg level) {
+		_level.store(static_cast<int>(level), std::memory_order_relaxed);
+	}
+
+	void Logger::log(const Dbg level, const std::string& where, const std::string& message) {
+		if (!isLogged(level)) return;
+
+#ifndef SUPER_HAXAGON_NO_THREADS
+		if (level != Dbg::FATAL && _running.load(std::memory_order_acquire)) {
+			if (!push(level, where, message)) _dropped.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+#endif
+
+		write(level, where, message);
+	}
+
+	void Logger::write(const Dbg level, const std::string& where, const std::string& message) {
+#ifndef SUPER_HAXAGON_NO_THREADS
+		// Anything still queued was logged first
+		std::lock_guard<std::mutex> lock(_output);
+		drain();
+#endif
+		_platform.output(level, where, message);
+	}
+
+#ifdef SUPER_HAXAGON_NO_THREADS
+	void Logger::start() {}
+
+	void Logger::stop() {}
+#else
+	static void copy(char* out, const std::string& in, const size_t size) {
+		const auto length = std::min(in.size(), size - 1);
+		std::memcpy(out, in.data(), length);
+		out[length] = '\0';
+	}
+
+	void Logger::start() {
+		if (_running.load(std::memory_order_relaxed)) return;
+
+		if (!_entries) {
+			_entries = std::make_unique<Entry[]>(ENTRIES);
+			for (size_t i = 0; i < ENTRIES; i++) _entries[i].sequence.store(i, std::memory_order_relaxed);
+		}
+
+		_running.store(true, std::memory_order_release);
+		_thread = std::thread(&Logger::run, this);
+	}
+
+	void Logger::stop() {
+		if (!_running.exchange(false)) return;
+		_wake.notify_one();
+		_thread.join();
+
+		std::lock_guard<std::mutex> lock(_output);
+		drain();
+	}
+
+	bool Logger::push(const Dbg level, const std::string& where, const std::string& message) {
+		// An entry is free for the producer at position pos once its sequence
+		// has come round to pos, and ready to write out once it is pos + 1
+		auto pos = _head.load(std::memory_order_relaxed);
+		Entry* entry;
+		while (true) {
+			entry = &_entries[pos & (ENTRIES - 1)];
+			const auto sequence = entry->sequence.load(std::memory_order_acquire);
+			const auto lap = static_cast<std::ptrdiff_t>(sequence - pos);
+			if (lap == 0) {
+				if (_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+			} else if (lap < 0) {
+				// Still holding what was pushed a lap ago, so the ring is full
+				return false;
+			} else {
+				pos = _head.load(std::memory_order_relaxed);
+			}
+		}
+
+		entry->level = level;
+		copy(entry->where, where, WHERE);
+		copy(entry->text, message, TEXT);
+		entry->sequence.store(pos + 1, std::memory_order_release);
+		_wake.notify_one();
+		return true;
+	}
+
+	void Logger::drain() {
+		if (!_entries) return;
+
+		while (true) {
+			auto& entry = _entries[_tail & (ENTRIES - 1)];
+			if (entry.sequence.load(std::memory_order_acquire) != _tail + 1) break;
+
+			_platform.output(entry.level, entry.where, entry.text);
+			entry.sequence.store(_tail + ENTRIES, std::memory_order_release);
+			_tail++;
+		}
+
+		const auto dropped = getDropped();
+		if (dropped != _reported) {
+			_platform.output(Dbg::WARN, "log", std::to_string(dropped - _reported) + " messages dropped, the log was full");
+			_reported = dropped;
+		}
+	}
+
+	void Logger::run() {
+		while (_running.load(std::memory_order_acquire)) {
+			{
+				std::lock_guard<std::mutex> lock(_output);
+				drain();
+			}
+
+			// A wake up that comes while draining is missed, which only costs a little delay
+			std::unique_lock<std::mutex> lock(_sleep);
+			_wake.wait_for(lock, std::chrono::milliseconds(100));
+		}
+	}
+#endif
+}
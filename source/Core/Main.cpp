@@ -57,15 +57,25 @@ int WinMain() {
 int main(int argc, char** argv) {
 #endif
 	const auto platform = SuperHaxagon::getPlatform(argc, argv);
+	platform->getLogger().start();
 	platform->message(SuperHaxagon::Dbg::INFO, "main", "starting main");
 
+	auto status = 0;
 	if (platform->loop()) {
 		SuperHaxagon::Game game(*platform);
 		game.run();
+
+#ifdef SUPER_HAXAGON_ALLOC_TRACK
+		// So a bench run fails when a steady state allocated
+		if (game.getSteadyAllocations()) status = 1;
+#endif
 	}
 
 	platform->message(SuperHaxagon::Dbg::INFO, "main", "stopping main");
+
+	// Shutting down may look back over the messages, so they all have to be out
+	platform->getLogger().stop();
 	platform->shutdown();
 
-	return 0;
+	return status;
 }
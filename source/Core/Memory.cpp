@@ -0,0 +1,120 @@
+#include "Core/Memory.hpp"
+
+#include "Core/Platform.hpp"
+
+#include <cstdio>
+#include <utility>
+
+namespace SuperHaxagon {
+	static unsigned toKB(const size_t bytes) {
+		return static_cast<unsigned>((bytes + 1023) / 1024);
+	}
+
+	MemoryCharge::MemoryCharge(Memory& memory, const MemoryTag tag, const size_t bytes) :
+		_memory(&memory),
+		_tag(tag),
+		_bytes(bytes) {}
+
+	MemoryCharge::MemoryCharge(MemoryCharge&& other) noexcept :
+		_memory(other._memory),
+		_tag(other._tag),
+		_bytes(other._bytes) {
+		other._memory = nullptr;
+		other._bytes = 0;
+	}
+
+	MemoryCharge& MemoryCharge::operator=(MemoryCharge&& other) noexcept {
+		if (this == &other) return *this;
+		release();
+		std::swap(_memory, other._memory);
+		std::swap(_tag, other._tag);
+		std::swap(_bytes, other._bytes);
+		return *this;
+	}
+
+	MemoryCharge::~MemoryCharge() {
+		release();
+	}
+
+	void MemoryCharge::resize(const size_t bytes) {
+		if (!_memory) return;
+		if (bytes > _bytes) _memory->add(_tag, bytes - _bytes);
+		else _memory->remove(_tag, _bytes - bytes);
+		_bytes = bytes;
+	}
+
+	void MemoryCharge::release() {
+		if (_memory) _memory->remove(_tag, _bytes);
+		_memory = nullptr;
+		_bytes = 0;
+	}
+
+	Memory::Memory(Platform& platform) : _platform(platform) {}
+
+	MemoryCharge Memory::reserve(const MemoryTag tag, const size_t bytes, const std::string& what) {
+		const auto index = static_cast<size_t>(tag);
+		const auto budget = _budgets[index];
+		auto current = _current[index].load(std::memory_order_relaxed);
+		do {
+			if (budget != UNLIMITED && current + bytes > budget) {
+				char line[128];
+				// What is left rounds down, so it never looks like it should have fit
+				std::snprintf(line, sizeof(line), "needs %u KB, but only %u KB of the %u KB %s budget is left",
+					toKB(bytes), static_cast<unsigned>((current < budget ? budget - current : 0) / 1024), toKB(budget), getName(tag));
+				_platform.message(Dbg::WARN, "memory", what + " " + line);
+				return {};
+			}
+		} while (!_current[index].compare_exchange_weak(current, current + bytes, std::memory_order_relaxed));
+
+		// Already counted, so this only has to look after the peak
+		auto peak = _peak[index].load(std::memory_order_relaxed);
+		while (current + bytes > peak && !_peak[index].compare_exchange_weak(peak, current + bytes, std::memory_order_relaxed)) {}
+		return {*this, tag, bytes};
+	}
+
+	MemoryCharge Memory::charge(const MemoryTag tag, const size_t bytes) {
+		add(tag, bytes);
+		return {*this, tag, bytes};
+	}
+
+	void Memory::report() const {
+		if (!_platform.isLogged(Dbg::INFO)) return;
+
+		for (size_t i = 0; i < TAGS; i++) {
+			const auto tag = static_cast<MemoryTag>(i);
+			char line[128];
+			if (getBudget(tag) == UNLIMITED) {
+				std::snprintf(line, sizeof(line), "%s %u KB, peak %u KB", getName(tag), toKB(getCurrent(tag)), toKB(getPeak(tag)));
+			} else {
+				std::snprintf(line, sizeof(line), "%s %u KB, peak %u KB, budget %u KB", getName(tag),
+					toKB(getCurrent(tag)), toKB(getPeak(tag)), toKB(getBudget(tag)));
+			}
+
+			_platform.message(Dbg::INFO, "memory", line);
+		}
+	}
+
+	const char* Memory::getName(const MemoryTag tag) {
+		switch (tag) {
+		case MemoryTag::LEVELS: return "levels";
+		case MemoryTag::PATTERNS: return "patterns";
+		case MemoryTag::AUDIO: return "audio";
+		case MemoryTag::FONTS: return "fonts";
+		case MemoryTag::RUNTIME: return "runtime";
+		case MemoryTag::COUNT: break;
+		}
+
+		return "?";
+	}
+
+	void Memory::add(const MemoryTag tag, const size_t bytes) {
+		const auto index = static_cast<size_t>(tag);
+		const auto now = _current[index].fetch_add(bytes, std::memory_order_relaxed) + bytes;
+		auto peak = _peak[index].load(std::memory_order_relaxed);
+		while (now > peak && !_peak[index].compare_exchange_weak(peak, now, std::memory_order_relaxed)) {}
+	}
+
+	void Memory::remove(const MemoryTag tag, const size_t bytes) {
+		_current[static_cast<size_t>(tag)].fetch_sub(bytes, std::memory_order_relaxed);
+	}
+}
@@ -0,0 +1,30 @@
+#include "Core/MessageHistory.hpp"
+
+#include "Core/Platform.hpp"
+
+#include <cstdio>
+
+namespace SuperHaxagon {
+	const char* MessageHistory::add(const Dbg level, const char* tag, const std::string& where, const std::string& message) {
+		auto& entry = _entries[_next];
+		entry.level = level;
+		std::snprintf(entry.text, LENGTH, "%s%s: %s", tag, where.c_str(), message.c_str());
+
+		_next = (_next + 1) % MESSAGES;
+		if (_count < MESSAGES) _count++;
+		return entry.text;
+	}
+
+	bool MessageHistory::hasFatal() const {
+		for (size_t i = 0; i < _count; i++) {
+			if (_entries[i].level == Dbg::FATAL) return true;
+		}
+
+		return false;
+	}
+
+	const char* MessageHistory::get(const size_t i) const {
+		const auto first = _count < MESSAGES ? 0 : _next;
+		return _entries[(first + i) % MESSAGES].text;
+	}
+}
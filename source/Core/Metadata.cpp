@@ -1,58 +1,85 @@
 #include "Core/Metadata.hpp"
 
-#include <sstream>
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <iterator>
+#include <istream>
 
 namespace SuperHaxagon {
+	// Every label the game acts on, each getting the bit of its place here.
+	// Play and Win look theirs up, so add new ones here as well.
+	static const char* const LABELS[] = {
+		"S", "I", "BL", "BS",                     // Spin, invert and pulses, in Play and Win
+		"HYPER", "PSURROUND", "C",                // The ending, in Win
+		"L0", "L1", "L2", "L3", "L4", "L5", "L6", // The level shown in the ending, in Win
+	};
+
+	static_assert(std::size(LABELS) <= Metadata::MAX_EVENTS, "Too many labels for the event mask");
+
 	Metadata::Metadata(const std::unique_ptr<std::istream> stream) {
 		if (!stream || !*stream) return;
-		
-		std::string line;
-		while (std::getline(*stream, line)) {
-			std::stringstream values(line);
-			std::string label;
-			float time;
-
-			// time gets repeated by Audacity for the label's
-			// duration. We can ignore it.
-			values >> time;
-			values.ignore(1, '\t');
-			values.ignore(256, '\t');
-			values >> label;
-
-			_timestamps[label].push_back(time);
+
+		const std::string text((std::istreambuf_iterator<char>(*stream)), std::istreambuf_iterator<char>());
+		const auto* it = text.c_str();
+		const auto* const end = it + text.size();
+		while (it < end) {
+			const auto* const line = it;
+			const auto* const eol = std::find(line, end, '\n');
+			it = eol + 1;
+
+			// Each line is "start<TAB>end<TAB>label". The end time is
+			// repeated by Audacity for the label's duration. We can ignore it.
+			char* after = nullptr;
+			const auto time = std::strtof(line, &after);
+			if (after == line || after >= eol || *after != '\t') continue;
+
+			const auto* label = std::find(static_cast<const char*>(after) + 1, eol, '\t');
+			while (label < eol && std::isspace(static_cast<unsigned char>(*label))) label++;
+			const auto* labelEnd = label;
+			while (labelEnd < eol && !std::isspace(static_cast<unsigned char>(*labelEnd))) labelEnd++;
+			if (label == labelEnd) continue;
+
+			const auto bit = getEvent(std::string(label, labelEnd));
+			if (bit) _timeline.push_back({time, bit});
 		}
+
+		std::stable_sort(_timeline.begin(), _timeline.end(), [](const Event& a, const Event& b) {
+			return a.time < b.time;
+		});
 	}
 
 	Metadata::~Metadata() = default;
 
-	bool Metadata::getMetadata(const float time, const std::string& label) {
-		if (_timestamps.find(label) == _timestamps.end()) return false; // no data
+	uint64_t Metadata::getEvent(const std::string& label) {
+		// Never written to, so BGMs loaded off the main thread need no lock
+		for (size_t i = 0; i < std::size(LABELS); i++) {
+			if (label == LABELS[i]) return static_cast<uint64_t>(1) << i;
+		}
 
-		// If more than 10 seconds behind, reset
-		if (time < _time - 10) _indices.clear();
-		_time = time;
+		return 0;
+	}
 
-		auto event = false;
-		// While not at end and the current timestamp is less than the requested one
-		// Note: C++ crates _indices[label] when it is accessed for the first time
-		while (_indices[label] != _timestamps[label].size() && _timestamps[label][_indices[label]] < time) {
-			_indices[label]++;
-			event = true;
+	uint64_t Metadata::advance(const float time) {
+		if (time < _time - RESYNC_TIME) {
+			_cursor = std::upper_bound(_timeline.begin(), _timeline.end(), time, [](const float t, const Event& event) {
+				return t < event.time;
+			}) - _timeline.begin();
+			_time = time;
+			return 0;
 		}
-		
-		return event;
-	}
 
-	float Metadata::getMaxTime() {
-		auto max = 0.0f;
-		for (const auto& timestamp : _timestamps) {
-			for (auto time : timestamp.second) {
-				if (time > max) {
-					max = time;
-				}
-			}
+		uint64_t events = 0;
+		while (_cursor < _timeline.size() && _timeline[_cursor].time <= time) {
+			events |= _timeline[_cursor].bit;
+			_cursor++;
 		}
 
-		return max;
+		_time = time;
+		return events;
+	}
+
+	float Metadata::getMaxTime() const {
+		return _timeline.empty() ? 0.0f : _timeline.back().time;
 	}
 }
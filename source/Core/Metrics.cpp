@@ -0,0 +1,86 @@
+#include "Core/Metrics.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <ostream>
+
+namespace SuperHaxagon {
+	// There is only ever one writer, so this does not need to be a locked add
+	template<typename T>
+	static void add(std::atomic<T>& value, const T amount) {
+		value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+	}
+
+	static void writeCounter(std::ostream& stream, const char* name, const char* help, const uint64_t value) {
+		stream << "# HELP " << name << " " << help << "\n";
+		stream << "# TYPE " << name << " counter\n";
+		stream << name << " " << value << "\n";
+	}
+
+	Histogram::Histogram(const std::array<float, BUCKETS>& bounds) : _bounds(bounds) {}
+
+	void Histogram::observe(const float seconds) {
+		size_t bucket = 0;
+		while (bucket < BUCKETS && seconds > _bounds[bucket]) bucket++;
+		add(_counts[bucket], 1u);
+		add(_micros, static_cast<uint64_t>(std::max(seconds, 0.0f) * 1000000.0f));
+	}
+
+	void Histogram::write(std::ostream& stream, const char* name, const char* help) const {
+		stream << "# HELP " << name << " " << help << "\n";
+		stream << "# TYPE " << name << " histogram\n";
+
+		// Buckets are cumulative when written out
+		uint64_t count = 0;
+		for (size_t i = 0; i <= BUCKETS; i++) {
+			count += _counts[i].load(std::memory_order_relaxed);
+			stream << name << "_bucket{le=\"";
+			if (i < BUCKETS) stream << _bounds[i];
+			else stream << "+Inf";
+			stream << "\"} " << count << "\n";
+		}
+
+		stream << name << "_sum " << static_cast<double>(_micros.load(std::memory_order_relaxed)) / 1000000.0 << "\n";
+		stream << name << "_count " << count << "\n";
+	}
+
+	Metrics::Metrics() :
+		_frames({0.004f, 0.008f, 0.0167f, 0.02f, 0.025f, 0.0334f, 0.05f, 0.1f}),
+		_levelLoads({0.01f, 0.025f, 0.05f, 0.1f, 0.25f, 0.5f, 1.0f, 2.5f}),
+		_bgmLoads({0.01f, 0.025f, 0.05f, 0.1f, 0.25f, 0.5f, 1.0f, 2.5f}),
+		_inputLatency({0.002f, 0.004f, 0.008f, 0.0125f, 0.0167f, 0.025f, 0.0334f, 0.05f}) {}
+
+	void Metrics::frame(const float dilation) {
+		const auto now = std::chrono::steady_clock::now();
+		const auto first = _last == std::chrono::steady_clock::time_point{};
+		const auto seconds = std::chrono::duration<float>(now - _last).count();
+		_last = now;
+		if (first) return;
+
+		_frames.observe(seconds);
+
+		// Every whole budget past the first is a frame that never made it out
+		const auto missed = std::lround(seconds / BUDGET_SECONDS) - 1;
+		if (missed > 0) add(_dropped, static_cast<uint64_t>(missed));
+		if (dilation > DILATION_SPIKE) add(_spikes, uint64_t{1});
+	}
+
+	void Metrics::levelPlayed() {
+		add(_levels, uint64_t{1});
+	}
+
+	void Metrics::setUnderruns(const uint32_t underruns) {
+		_underruns.store(underruns, std::memory_order_relaxed);
+	}
+
+	void Metrics::write(std::ostream& stream) const {
+		_frames.write(stream, "super_haxagon_frame_seconds", "Time between the starts of two frames.");
+		writeCounter(stream, "super_haxagon_dropped_frames_total", "Frames missed at 60 FPS.", _dropped.load(std::memory_order_relaxed));
+		writeCounter(stream, "super_haxagon_dilation_spikes_total", "Frames where the game stepped more than two frames at once.", _spikes.load(std::memory_order_relaxed));
+		writeCounter(stream, "super_haxagon_audio_underruns_total", "Times the audio output ran dry.", _underruns.load(std::memory_order_relaxed));
+		writeCounter(stream, "super_haxagon_levels_played_total", "Levels started.", _levels.load(std::memory_order_relaxed));
+		_levelLoads.write(stream, "super_haxagon_level_load_seconds", "Time taken to load a level file.");
+		_bgmLoads.write(stream, "super_haxagon_bgm_load_seconds", "Time taken to load a BGM and its labels.");
+		_inputLatency.write(stream, "super_haxagon_input_latency_seconds", "Time from reading input to presenting the frame.");
+	}
+}
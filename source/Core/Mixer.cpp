@@ -0,0 +1,489 @@
+#include "Core/Mixer.hpp"
+
+#include "Core/OggStream.hpp"
+#include "Core/Sound.hpp"
+#include "Core/Trace.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SUPER_HAXAGON_MIXER_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#define SUPER_HAXAGON_MIXER_NEON
+#include <arm_neon.h>
+#endif
+
+#ifndef SUPER_HAXAGON_NO_THREADS
+#include <chrono>
+#endif
+
+namespace SuperHaxagon {
+	static constexpr uint64_t FIXED_ONE = 1 << 16;
+
+	// A handle is the voice in the low bits and its generation above, kept positive
+	static constexpr int SLOT_BITS = 8;
+	static constexpr uint32_t GENERATION_MASK = (1u << (31 - SLOT_BITS)) - 1;
+	static_assert(Mixer::VOICES <= 1 << SLOT_BITS, "voices do not fit in a handle");
+
+	// Adds frames of 16 bit audio at the sound's own rate onto the stereo float mix
+	static void mixFrames(const int16_t* in, const int channels, const float gain, float* out, const size_t frames) {
+		size_t i = 0;
+#if defined(SUPER_HAXAGON_MIXER_SSE2)
+		const auto g = _mm_set1_ps(gain);
+		if (channels == 1) {
+			for (; i + 8 <= frames; i += 8) {
+				const auto s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+				const auto lo = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(s, s), 16)), g);
+				const auto hi = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(s, s), 16)), g);
+				auto* o = out + i * 2;
+				_mm_storeu_ps(o, _mm_add_ps(_mm_loadu_ps(o), _mm_unpacklo_ps(lo, lo)));
+				_mm_storeu_ps(o + 4, _mm_add_ps(_mm_loadu_ps(o + 4), _mm_unpackhi_ps(lo, lo)));
+				_mm_storeu_ps(o + 8, _mm_add_ps(_mm_loadu_ps(o + 8), _mm_unpacklo_ps(hi, hi)));
+				_mm_storeu_ps(o + 12, _mm_add_ps(_mm_loadu_ps(o + 12), _mm_unpackhi_ps(hi, hi)));
+			}
+		} else {
+			for (; i + 4 <= frames; i += 4) {
+				const auto s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i * 2));
+				const auto lo = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(s, s), 16)), g);
+				const auto hi = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(s, s), 16)), g);
+				auto* o = out + i * 2;
+				_mm_storeu_ps(o, _mm_add_ps(_mm_loadu_ps(o), lo));
+				_mm_storeu_ps(o + 4, _mm_add_ps(_mm_loadu_ps(o + 4), hi));
+			}
+		}
+#elif defined(SUPER_HAXAGON_MIXER_NEON)
+		if (channels == 1) {
+			for (; i + 8 <= frames; i += 8) {
+				const auto s = vld1q_s16(in + i);
+				const auto lo = vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(s))), gain);
+				const auto hi = vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(s))), gain);
+				const auto a = vzipq_f32(lo, lo);
+				const auto b = vzipq_f32(hi, hi);
+				auto* o = out + i * 2;
+				vst1q_f32(o, vaddq_f32(vld1q_f32(o), a.val[0]));
+				vst1q_f32(o + 4, vaddq_f32(vld1q_f32(o + 4), a.val[1]));
+				vst1q_f32(o + 8, vaddq_f32(vld1q_f32(o + 8), b.val[0]));
+				vst1q_f32(o + 12, vaddq_f32(vld1q_f32(o + 12), b.val[1]));
+			}
+		} else {
+			for (; i + 4 <= frames; i += 4) {
+				const auto s = vld1q_s16(in + i * 2);
+				const auto lo = vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(s))), gain);
+				const auto hi = vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(s))), gain);
+				auto* o = out + i * 2;
+				vst1q_f32(o, vaddq_f32(vld1q_f32(o), lo));
+				vst1q_f32(o + 4, vaddq_f32(vld1q_f32(o + 4), hi));
+			}
+		}
+#endif
+		for (; i < frames; i++) {
+			const auto left = static_cast<float>(in[i * channels]) * gain;
+			const auto right = static_cast<float>(in[i * channels + channels - 1]) * gain;
+			out[i * 2] += left;
+			out[i * 2 + 1] += right;
+		}
+	}
+
+	// Converts the float mix back to 16 bit, clipping anything too loud
+	static void convert(const float* in, int16_t* out, const size_t samples) {
+		size_t i = 0;
+#if defined(SUPER_HAXAGON_MIXER_SSE2)
+		for (; i + 8 <= samples; i += 8) {
+			const auto a = _mm_cvtps_epi32(_mm_loadu_ps(in + i));
+			const auto b = _mm_cvtps_epi32(_mm_loadu_ps(in + i + 4));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packs_epi32(a, b));
+		}
+#elif defined(SUPER_HAXAGON_MIXER_NEON)
+		for (; i + 8 <= samples; i += 8) {
+			const auto a = vqmovn_s32(vcvtnq_s32_f32(vld1q_f32(in + i)));
+			const auto b = vqmovn_s32(vcvtnq_s32_f32(vld1q_f32(in + i + 4)));
+			vst1q_s16(out + i, vcombine_s16(a, b));
+		}
+#endif
+		// Round to nearest even, the same as the vector paths
+		for (; i < samples; i++) {
+			out[i] = static_cast<int16_t>(std::max(-32768.0f, std::min(32767.0f, std::nearbyint(in[i]))));
+		}
+	}
+
+	// Samples a voice's stage needs for a block of a stream or a compressed
+	// sound, at the highest rate and with the largest compressed block
+	static size_t getStageSize() {
+		size_t size = 0;
+		for (auto channels = 1; channels <= Mixer::CHANNELS; channels++) {
+			const auto group = static_cast<size_t>(4 * channels);
+			const auto blockFrames = (Sound::MAX_ALIGN / group * group - group) * 2 / channels + 1;
+			size = std::max(size, (Mixer::BLOCK_FRAMES * Mixer::MAX_STEP + 2 + blockFrames) * channels);
+		}
+
+		return size;
+	}
+
+	Mixer::Mixer(const int rate, const size_t latencyFrames) :
+		_rate(rate),
+		_messages(VOICES * 4),
+		_finished(VOICES),
+		_output(latencyFrames * CHANNELS),
+		_accum(BLOCK_FRAMES * CHANNELS),
+		_block(BLOCK_FRAMES * CHANNELS) {
+		// Enough that the renderer never writes over a block still being pulled,
+		// in a power of two so block numbers can wrap
+		size_t marks = 1;
+		while (marks < _output.getCapacity() / _block.size() + 2) marks <<= 1;
+		_marks.resize(marks);
+
+		const auto stage = getStageSize();
+		for (auto& voice : _voices) voice.stage.resize(stage);
+
+#ifndef SUPER_HAXAGON_NO_THREADS
+		_thread = std::thread([this] {
+			while (_running.load(std::memory_order_acquire)) {
+				pump();
+				std::this_thread::sleep_for(std::chrono::milliseconds(2));
+			}
+		});
+#endif
+	}
+
+	Mixer::~Mixer() {
+#ifndef SUPER_HAXAGON_NO_THREADS
+		_running.store(false, std::memory_order_release);
+		_thread.join();
+#endif
+	}
+
+	int Mixer::play(std::shared_ptr<const Sound> sound, const bool loop, const float gain) {
+		if (!sound || sound->getFrames() == 0 || sound->rate > _rate * MAX_STEP) return -1;
+		const auto rate = sound->rate;
+		return start({Command::PLAY, 0, std::move(sound), nullptr, loop, gain}, rate);
+	}
+
+	int Mixer::play(std::shared_ptr<OggStream> stream, const float gain) {
+		if (!stream || !stream->isOpen() || stream->getRate() > _rate * MAX_STEP) return -1;
+		const auto rate = stream->getRate();
+		return start({Command::PLAY, 0, nullptr, std::move(stream), false, gain}, rate);
+	}
+
+	int Mixer::start(Message message, const int rate) {
+		collect();
+
+		// Only the game claims voices, the renderer only frees them
+		for (auto voice = 0; voice < VOICES; voice++) {
+			if (_busy[voice].load(std::memory_order_acquire)) continue;
+
+			_rates[voice] = rate;
+			_clocks[voice].restart();
+			_busy[voice].store(true, std::memory_order_release);
+			message.voice = voice;
+			if (!_messages.push(message)) {
+				_busy[voice].store(false, std::memory_order_release);
+				return -1;
+			}
+
+			// Anything still holding the last handle to this voice is now stale
+			const auto generation = ++_generations[voice] & GENERATION_MASK;
+			return static_cast<int>(generation << SLOT_BITS) | voice;
+		}
+
+		return -1;
+	}
+
+	void Mixer::collect() {
+		// Dropped here, as the last owner may have to join a decoder thread
+		Message message;
+		while (_finished.pop(message)) {}
+	}
+
+	void Mixer::stop(const int handle) {
+		send(Command::STOP, handle);
+	}
+
+	void Mixer::setPaused(const int handle, const bool paused) {
+		send(paused ? Command::PAUSE : Command::RESUME, handle);
+	}
+
+	void Mixer::setGain(const int handle, const float gain) {
+		send(Command::GAIN, handle, gain);
+	}
+
+	bool Mixer::isPlaying(const int handle) const {
+		const auto voice = getSlot(handle);
+		return voice >= 0 && _busy[voice].load(std::memory_order_acquire);
+	}
+
+	float Mixer::getTime(const int handle) const {
+		const auto voice = getSlot(handle);
+		if (voice < 0) return 0.0f;
+		return _clocks[voice].getTime();
+	}
+
+	int Mixer::getSlot(const int handle) const {
+		if (handle < 0) return -1;
+		const auto voice = handle & ((1 << SLOT_BITS) - 1);
+		const auto generation = static_cast<uint32_t>(handle) >> SLOT_BITS;
+		if (voice >= VOICES || generation != (_generations[voice] & GENERATION_MASK)) return -1;
+		return voice;
+	}
+
+	void Mixer::pump() {
+		const auto began = _trace ? Trace::now() : 0;
+		size_t blocks = 0;
+		while (_output.getSpace() >= _block.size()) {
+			blocks++;
+#ifndef SUPER_HAXAGON_NO_THREADS
+			const auto start = std::chrono::steady_clock::now();
+			render(_block.data(), BLOCK_FRAMES);
+			const std::chrono::duration<float> elapsed = std::chrono::steady_clock::now() - start;
+
+			// Smoothed over roughly the last twenty blocks
+			const auto load = elapsed.count() / (static_cast<float>(BLOCK_FRAMES) / static_cast<float>(_rate));
+			_load.store(_load.load(std::memory_order_relaxed) * 0.95f + load * 0.05f, std::memory_order_relaxed);
+#else
+			render(_block.data(), BLOCK_FRAMES);
+#endif
+			_output.write(_block.data(), _block.size());
+		}
+
+		if (!_trace) return;
+
+		// Formatted on the stack, so tracing does not allocate either
+		char detail[Trace::DETAIL];
+		if (blocks) {
+			std::snprintf(detail, sizeof(detail), "%u blocks", static_cast<unsigned>(blocks));
+			_trace->span(Trace::Track::AUDIO, "mix", began, Trace::now(), detail);
+		}
+
+		// The device cannot wait on the trace, so its underruns are picked up here
+		const auto underruns = getUnderruns();
+		if (underruns != _traced) {
+			std::snprintf(detail, sizeof(detail), "%u", static_cast<unsigned>(underruns - _traced));
+			_trace->instant(Trace::Track::AUDIO, "underrun", detail);
+		}
+
+		_traced = underruns;
+	}
+
+	size_t Mixer::pull(int16_t* out, const size_t frames) {
+		const auto first = _pulled;
+		const auto samples = _output.read(out, frames * CHANNELS);
+		if (samples < frames * CHANNELS) {
+			std::fill(out + samples, out + frames * CHANNELS, 0);
+			_underruns.store(_underruns.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+		}
+
+		_pulled += static_cast<uint32_t>(samples / CHANNELS);
+		if (samples) publish(first, frames);
+		return samples / CHANNELS;
+	}
+
+	void Mixer::publish(const uint32_t first, const size_t frames) {
+		const auto& mark = _marks[(first / BLOCK_FRAMES) & (_marks.size() - 1)];
+
+		// These frames are heard after the ones the device is playing now
+		const auto offset = (static_cast<float>(first % BLOCK_FRAMES) - static_cast<float>(frames)) / static_cast<float>(_rate);
+		for (auto i = 0; i < VOICES; i++) {
+			const auto running = (mark.running >> i & 1) != 0;
+			_clocks[i].publish(std::max(0.0f, mark.times[i] + (running ? offset : 0.0f)), running);
+		}
+	}
+
+	void Mixer::send(const Command command, const int handle, const float gain) {
+		const auto voice = getSlot(handle);
+		if (voice < 0) return;
+		_messages.push({command, voice, nullptr, nullptr, false, gain});
+	}
+
+	void Mixer::receive() {
+		Message message;
+		while (_messages.pop(message)) {
+			auto& voice = _voices[message.voice];
+			switch (message.command) {
+			case Command::PLAY:
+				voice.sound = std::move(message.sound);
+				voice.stream = std::move(message.stream);
+				voice.position = 0;
+				voice.step = static_cast<uint64_t>(_rates[message.voice]) * FIXED_ONE / static_cast<uint64_t>(_rate);
+				voice.staged = 0;
+				voice.block = 0;
+				voice.source = 0;
+				voice.gain = message.gain;
+				voice.loop = message.loop;
+				voice.paused = false;
+				break;
+			case Command::STOP:
+				if (voice.sound || voice.stream) finish(message.voice);
+				break;
+			case Command::PAUSE:
+				voice.paused = true;
+				break;
+			case Command::RESUME:
+				voice.paused = false;
+				break;
+			case Command::GAIN:
+				voice.gain = message.gain;
+				break;
+			}
+		}
+	}
+
+	void Mixer::render(int16_t* out, const size_t frames) {
+		receive();
+
+		auto& mark = _marks[_rendered++ & (_marks.size() - 1)];
+		mark.running = 0;
+
+		std::fill(_accum.begin(), _accum.begin() + frames * CHANNELS, 0.0f);
+		for (auto i = 0; i < VOICES; i++) {
+			auto& voice = _voices[i];
+			if (!voice.sound && !voice.stream) {
+				mark.times[i] = 0.0f;
+				continue;
+			}
+
+			mark.times[i] = getPosition(voice, i);
+			if (voice.paused) continue;
+
+			mark.running |= 1u << i;
+			const auto staged = voice.stream || voice.sound->isCompressed();
+			if (!(staged ? mixStaged(voice, _accum.data(), frames) : mix(voice, _accum.data(), frames))) {
+				finish(i);
+			}
+		}
+
+		convert(_accum.data(), out, frames * CHANNELS);
+	}
+
+	bool Mixer::mix(Voice& voice, float* accum, const size_t frames) const {
+		const auto& sound = *voice.sound;
+		const auto* samples = sound.samples.data();
+		const auto channels = sound.channels;
+		const auto total = static_cast<uint64_t>(sound.getFrames());
+
+		size_t i = 0;
+		while (i < frames) {
+			const auto index = voice.position / FIXED_ONE;
+			if (index >= total) {
+				if (!voice.loop) return false;
+				voice.position -= total * FIXED_ONE;
+				continue;
+			}
+
+			// Same rate as the mixer, so whole runs can be mixed at once
+			if (voice.step == FIXED_ONE) {
+				const auto run = static_cast<size_t>(std::min<uint64_t>(frames - i, total - index));
+				mixFrames(samples + index * channels, channels, voice.gain, accum + i * CHANNELS, run);
+				voice.position += run * FIXED_ONE;
+				i += run;
+				continue;
+			}
+
+			// Otherwise step through it, interpolating between neighbours
+			const auto next = index + 1 < total ? index + 1 : (voice.loop ? 0 : index);
+			const auto fraction = static_cast<float>(voice.position % FIXED_ONE) / FIXED_ONE;
+			for (auto c = 0; c < CHANNELS; c++) {
+				const auto channel = std::min(c, channels - 1);
+				const auto a = static_cast<float>(samples[index * channels + channel]);
+				const auto b = static_cast<float>(samples[next * channels + channel]);
+				accum[i * CHANNELS + c] += (a + (b - a) * fraction) * voice.gain;
+			}
+
+			voice.position += voice.step;
+			i++;
+		}
+
+		return true;
+	}
+
+	bool Mixer::mixStaged(Voice& voice, float* accum, const size_t frames) const {
+#ifdef SUPER_HAXAGON_NO_THREADS
+		// Nobody else is going to decode it
+		if (voice.stream) voice.stream->pump();
+#endif
+
+		// Make sure the stage reaches one frame past the last one this block touches
+		const auto channels = voice.stream ? voice.stream->getChannels() : voice.sound->channels;
+		const auto needed = static_cast<size_t>((voice.position + (frames - 1) * voice.step) / FIXED_ONE) + 2;
+		while (voice.staged < needed) {
+			const auto read = voice.stream ? voice.stream->read(&voice.stage[voice.staged * channels], needed - voice.staged) : decode(voice);
+			if (!read) break;
+			voice.staged += read;
+		}
+
+		if (voice.staged < needed) {
+			const auto drained = voice.stream ? voice.stream->isDone() : !voice.loop && voice.block >= voice.sound->getBlocks();
+			if (drained && voice.staged <= 1) return false;
+
+			// Late or at the very end, fill the gap with silence
+			std::fill(voice.stage.begin() + voice.staged * channels, voice.stage.begin() + needed * channels, 0);
+			voice.staged = needed;
+		}
+
+		const auto* stage = voice.stage.data();
+		if (voice.step == FIXED_ONE && voice.position == 0) {
+			// Nothing to interpolate, the stage lines up with the mix
+			mixFrames(stage, channels, voice.gain, accum, frames);
+		} else {
+			for (size_t i = 0; i < frames; i++) {
+				const auto position = voice.position + i * voice.step;
+				const auto index = static_cast<size_t>(position / FIXED_ONE);
+				const auto fraction = static_cast<float>(position % FIXED_ONE) / FIXED_ONE;
+				for (auto c = 0; c < CHANNELS; c++) {
+					const auto channel = std::min(c, channels - 1);
+					const auto a = static_cast<float>(stage[index * channels + channel]);
+					const auto b = static_cast<float>(stage[(index + 1) * channels + channel]);
+					accum[i * CHANNELS + c] += (a + (b - a) * fraction) * voice.gain;
+				}
+			}
+		}
+
+		// Drop the frames that were passed, the position only keeps its fraction
+		const auto end = voice.position + frames * voice.step;
+		const auto advance = static_cast<size_t>(end / FIXED_ONE);
+		std::copy(voice.stage.begin() + advance * channels, voice.stage.begin() + voice.staged * channels, voice.stage.begin());
+		voice.staged -= advance;
+		voice.position = end % FIXED_ONE;
+		return true;
+	}
+
+	size_t Mixer::decode(Voice& voice) const {
+		const auto& sound = *voice.sound;
+		if (voice.block >= sound.getBlocks()) {
+			if (!voice.loop) return 0;
+
+			// The first block follows straight on from the last
+			voice.block = 0;
+			voice.source = 0;
+		}
+
+		const auto read = decodeAdpcm(sound, voice.block++, &voice.stage[voice.staged * sound.channels]);
+		voice.source += read;
+		return read;
+	}
+
+	float Mixer::getPosition(const Voice& voice, const int index) const {
+		const auto fraction = static_cast<double>(voice.position) / FIXED_ONE;
+		if (!voice.stream && !voice.sound->isCompressed()) return static_cast<float>(fraction / _rates[index]);
+
+		// What is waiting on the stage has already been handed over
+		const auto staged = static_cast<double>(voice.staged) - fraction;
+		if (voice.stream) return std::max(0.0f, voice.stream->getTime() - static_cast<float>(staged / _rates[index]));
+
+		// Just after a loop the stage still holds the end of the last time through
+		auto frames = static_cast<double>(voice.source) - staged;
+		if (frames < 0) frames += static_cast<double>(voice.sound->getFrames());
+		return static_cast<float>(std::max(0.0, frames) / _rates[index]);
+	}
+
+	void Mixer::finish(const int voice) {
+		// A voice is only claimed again after the game has collected, so
+		// there is always room for every voice to hand its sound back
+		Message message{Command::STOP, voice, std::move(_voices[voice].sound), std::move(_voices[voice].stream), false, 0.0f};
+		_voices[voice].sound = nullptr;
+		_voices[voice].stream = nullptr;
+		_finished.push(message);
+		_busy[voice].store(false, std::memory_order_release);
+	}
+}
@@ -0,0 +1,50 @@
+#include "Core/MusicClock.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+namespace SuperHaxagon {
+	MusicClock::MusicClock() : _stamp(now()) {}
+
+	void MusicClock::publish(const float position, const bool running) {
+		const auto sequence = _sequence.load(std::memory_order_relaxed);
+		_sequence.store(sequence + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		_position.store(position, std::memory_order_relaxed);
+		_stamp.store(now(), std::memory_order_relaxed);
+		_running.store(running, std::memory_order_relaxed);
+		_sequence.store(sequence + 2, std::memory_order_release);
+	}
+
+	float MusicClock::getTime() const {
+		float position;
+		uint32_t stamp;
+		bool running;
+		while (true) {
+			const auto before = _sequence.load(std::memory_order_acquire);
+			position = _position.load(std::memory_order_relaxed);
+			stamp = _stamp.load(std::memory_order_relaxed);
+			running = _running.load(std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (!(before & 1) && before == _sequence.load(std::memory_order_relaxed)) break;
+		}
+
+		auto time = position;
+		if (running) {
+			// Unsigned, so this still works when the microseconds wrap
+			const auto elapsed = static_cast<float>(now() - stamp) / 1.0e6f;
+			time += std::min(elapsed, MAX_EXTRAPOLATION);
+		}
+
+		// The last guess ran a little ahead of what the audio side just said
+		if (time < _last && _last - time < MAX_EXTRAPOLATION) return _last;
+		_last = time;
+		return time;
+	}
+
+	uint32_t MusicClock::now() {
+		using namespace std::chrono;
+		static const auto epoch = steady_clock::now();
+		return static_cast<uint32_t>(duration_cast<microseconds>(steady_clock::now() - epoch).count());
+	}
+}
@@ -0,0 +1,152 @@
+#include "Core/OggStream.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+
+#ifndef SUPER_HAXAGON_NO_THREADS
+#include <chrono>
+#endif
+
+#include <stb_vorbis.c>
+
+namespace SuperHaxagon {
+	static stb_vorbis* openVorbis(const std::string& path) {
+		auto error = 0;
+		auto* vorbis = stb_vorbis_open_filename(path.c_str(), &error, nullptr);
+		if (!vorbis) return nullptr;
+
+		const auto channels = stb_vorbis_get_info(vorbis).channels;
+		if (error || !(channels == 1 || channels == 2)) {
+			stb_vorbis_close(vorbis);
+			return nullptr;
+		}
+
+		return vorbis;
+	}
+
+	OggStream::OggStream(const std::string& path, const int latencyMs) :
+		_vorbis(openVorbis(path)),
+		_rate(_vorbis ? static_cast<int>(stb_vorbis_get_info(_vorbis).sample_rate) : 0),
+		_channels(_vorbis ? stb_vorbis_get_info(_vorbis).channels : 0),
+		_chunk(CHUNK_FRAMES * std::max(_channels, 1)),
+		_ring(static_cast<size_t>(_rate) * _channels * latencyMs / 1000 + _chunk.size()) {
+		if (!_vorbis) return;
+
+		const auto length = stb_vorbis_stream_length_in_samples(_vorbis);
+		_loopStart = getComment("LOOPSTART", 0);
+		const auto loopLength = getComment("LOOPLENGTH", 0);
+		_loopEnd = loopLength ? _loopStart + loopLength : getComment("LOOPEND", length);
+		if (_loopEnd > length || _loopEnd <= _loopStart) {
+			_loopStart = 0;
+			_loopEnd = length;
+		}
+
+		// Fill up front so the first read already has audio
+		pump();
+
+#ifndef SUPER_HAXAGON_NO_THREADS
+		const auto sleep = std::chrono::milliseconds(std::max(1, latencyMs / 4));
+		_thread = std::thread([this, sleep] {
+			while (_running.load(std::memory_order_acquire)) {
+				pump();
+				std::this_thread::sleep_for(sleep);
+			}
+		});
+#endif
+	}
+
+	OggStream::~OggStream() {
+#ifndef SUPER_HAXAGON_NO_THREADS
+		_running.store(false, std::memory_order_release);
+		if (_thread.joinable()) _thread.join();
+#endif
+		if (_vorbis) stb_vorbis_close(_vorbis);
+	}
+
+	void OggStream::setLoop(const bool loop) {
+		_loop.store(loop, std::memory_order_release);
+	}
+
+	void OggStream::pump() {
+		if (!_vorbis || _finished.load(std::memory_order_acquire)) return;
+
+		while (_ring.getSpace() >= _chunk.size()) {
+			// Songs that are not looping play past the loop end to the real end
+			const auto loop = _loop.load(std::memory_order_acquire);
+			auto want = static_cast<uint32_t>(CHUNK_FRAMES);
+			if (loop && _loopEnd > _cursor) want = std::min(want, _loopEnd - _cursor);
+
+			const auto frames = stb_vorbis_get_samples_short_interleaved(_vorbis, _channels, _chunk.data(), static_cast<int>(want) * _channels);
+			if (frames > 0) {
+				_ring.write(_chunk.data(), static_cast<size_t>(frames) * _channels);
+				_cursor += static_cast<uint32_t>(frames);
+			}
+
+			if (frames > 0 && (!loop || _loopEnd == 0 || _cursor < _loopEnd)) continue;
+
+			// Nothing decodes from the loop start either, so give up
+			if (!loop || (frames <= 0 && _cursor == _loopStart)) {
+				_finished.store(true, std::memory_order_release);
+				return;
+			}
+
+			if (_loopStart == 0) {
+				stb_vorbis_seek_start(_vorbis);
+			} else {
+				stb_vorbis_seek(_vorbis, _loopStart);
+			}
+
+			_cursor = _loopStart;
+		}
+	}
+
+	size_t OggStream::read(int16_t* out, const size_t frames) {
+		const auto read = _ring.read(out, frames * _channels) / std::max(_channels, 1);
+		_consumed.store(_consumed.load(std::memory_order_relaxed) + static_cast<uint32_t>(read), std::memory_order_release);
+		if (read < frames && !_finished.load(std::memory_order_acquire)) {
+			_underruns.store(_underruns.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+		}
+
+		return read;
+	}
+
+	bool OggStream::isDone() const {
+		return !_vorbis || (_finished.load(std::memory_order_acquire) && _ring.getAvailable() == 0);
+	}
+
+	float OggStream::getTime() const {
+		if (!_rate) return 0.0f;
+		auto position = _consumed.load(std::memory_order_acquire);
+		if (_loop.load(std::memory_order_acquire) && position >= _loopEnd && _loopEnd > _loopStart) {
+			position = _loopStart + (position - _loopEnd) % (_loopEnd - _loopStart);
+		}
+
+		return static_cast<float>(position) / static_cast<float>(_rate);
+	}
+
+	uint32_t OggStream::getLoops() const {
+		const auto position = _consumed.load(std::memory_order_acquire);
+		if (!_loop.load(std::memory_order_acquire) || position < _loopEnd || _loopEnd <= _loopStart) return 0;
+		return 1 + (position - _loopEnd) / (_loopEnd - _loopStart);
+	}
+
+	uint32_t OggStream::getComment(const char* key, const uint32_t fallback) const {
+		const auto comments = stb_vorbis_get_comment(_vorbis);
+		const auto length = std::strlen(key);
+		for (auto i = 0; i < comments.comment_list_length; i++) {
+			const auto* comment = comments.comment_list[i];
+
+			// Comments are KEY=VALUE, with keys in any case
+			auto match = true;
+			for (size_t c = 0; c < length && match; c++) {
+				match = comment[c] && std::toupper(static_cast<unsigned char>(comment[c])) == key[c];
+			}
+
+			if (match && comment[length] == '=') return static_cast<uint32_t>(std::strtoul(comment + length + 1, nullptr, 10));
+		}
+
+		return fallback;
+	}
+}
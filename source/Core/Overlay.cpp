@@ -0,0 +1,95 @@
+#include "Core/Overlay.hpp"
+
+#include "Core/Allocations.hpp"
+#include "Core/Font.hpp"
+#include "Core/Game.hpp"
+#include "Core/Platform.hpp"
+#include "Core/Structs.hpp"
+#include "Objects/Level.hpp"
+
+#include <algorithm>
+#include <array>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace SuperHaxagon {
+	static std::string toMs(const float ms) {
+		std::stringstream buffer;
+		buffer << std::fixed << std::setprecision(1) << ms;
+		return buffer.str();
+	}
+
+	Overlay::Overlay(Game& game) : _game(game) {}
+
+	void Overlay::draw(const float scale, const Level* level) const {
+		auto& platform = _game.getPlatform();
+		const auto& profiler = platform.getProfiler();
+		auto& small = _game.getFontSmall();
+		small.setScale(scale);
+
+		std::array<float, Profiler::FRAMES> times{};
+		size_t count = 0;
+		while (count < times.size()) {
+			const auto* frame = profiler.getFrame(count);
+			if (!frame) break;
+			times[count++] = frame->total;
+		}
+
+		std::vector<std::string> lines;
+		if (count) {
+			// The graph wants them in order, so percentiles work on a copy
+			auto sorted = times;
+			std::sort(sorted.begin(), sorted.begin() + count);
+			const auto p50 = sorted[count / 2];
+			const auto p99 = sorted[std::min(count - 1, count * 99 / 100)];
+			lines.emplace_back("FRAME " + toMs(p50) + " P99 " + toMs(p99) + " MS");
+
+			const auto& last = *profiler.getFrame(0);
+			lines.emplace_back("POLYS " + std::to_string(last.calls[static_cast<size_t>(Zone::DRAW_POLY)]) + " VERTS " + std::to_string(last.vertices));
+			if (Allocations::TRACKING) lines.emplace_back("ALLOCS " + std::to_string(last.allocs) + " BYTES " + std::to_string(last.allocBytes));
+		} else {
+			lines.emplace_back("NO PROFILER");
+		}
+
+		if (level) {
+			size_t walls = 0;
+			for (const auto& pattern : level->getPatterns()) walls += pattern.getWalls().size();
+			lines.emplace_back("PATTERNS " + std::to_string(level->getPatterns().size()) + " WALLS " + std::to_string(walls));
+		}
+
+		const auto fill = platform.getAudioFill();
+		lines.emplace_back(fill < 0 ? "AUDIO ?" : "AUDIO " + std::to_string(static_cast<int>(fill * 100.0f)) + "%");
+
+		const auto pad = 3 * scale;
+		const auto bar = 2 * scale;
+		const auto graphHeight = 30 * scale;
+		auto width = bar * GRAPH_FRAMES;
+		for (const auto& line : lines) width = std::max(width, small.getWidth(line));
+
+		const auto screen = platform.getScreenDim();
+		const auto lineHeight = small.getHeight() + pad;
+		const Point size = {width + pad * 2, graphHeight + lineHeight * lines.size() + pad * 2};
+		const Point corner = {0, screen.y - size.y};
+		_game.drawRect(COLOR_TRANSPARENT, corner, size);
+
+		// Oldest on the left, and twice the budget fills the graph
+		const auto graphBottom = corner.y + pad + graphHeight;
+		const auto shown = std::min(count, GRAPH_FRAMES);
+		for (size_t i = 0; i < shown; i++) {
+			const auto ms = times[shown - 1 - i];
+			const auto height = std::min(ms / (Profiler::BUDGET_MS * 2.0f), 1.0f) * graphHeight;
+			const auto color = ms > Profiler::BUDGET_MS * Profiler::HITCH ? COLOR_RED : COLOR_WHITE;
+			_game.drawRect(color, {corner.x + pad + bar * i, graphBottom - height}, {bar, height});
+		}
+
+		_game.drawRect(COLOR_GREY, {corner.x + pad, graphBottom - graphHeight / 2}, {bar * GRAPH_FRAMES, scale});
+
+		auto y = graphBottom + pad;
+		for (const auto& line : lines) {
+			small.draw(COLOR_WHITE, {corner.x + pad, y}, Alignment::LEFT, line);
+			y += lineHeight;
+		}
+	}
+}
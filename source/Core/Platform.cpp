@@ -1,6 +1,12 @@
 #include "Core/Platform.hpp"
 
+#include <algorithm>
 #include <fstream>
+#include <utility>
+
+#ifndef SUPER_HAXAGON_NO_THREADS
+#include <thread>
+#endif
 
 namespace SuperHaxagon {
 	std::unique_ptr<std::istream> Platform::openFile(const std::string& partial, const Location location) {
@@ -11,14 +17,64 @@ namespace SuperHaxagon {
 		_bgm = nullptr;
 	}
 	
+	std::unique_ptr<AudioPlayer> Platform::swapBGM(std::unique_ptr<AudioPlayer> bgm) {
+		std::swap(_bgm, bgm);
+		if (_bgm) {
+			_bgm->setLoop(true);
+			_bgm->play();
+		}
+
+		return bgm;
+	}
+
 	AudioPlayer* Platform::getBGM() {
 		return _bgm.get();
 	}
 
+	float Platform::getAudioFill() const {
+		return -1.0f;
+	}
+
+	uint32_t Platform::getAudioUnderruns() const {
+		return 0;
+	}
+
+	Held Platform::getHeld() {
+		const auto pressed = getPressed();
+		if (pressed.left) return {1, 0};
+		if (pressed.right) return {0, 1};
+		return {0, 0};
+	}
+
+	void Platform::setSampling(bool) {
+		// By default input is only read when asked for
+	}
+
+	size_t Platform::getCores() const {
+#ifdef SUPER_HAXAGON_NO_THREADS
+		return 1;
+#else
+		// Zero when the library cannot tell
+		return std::max<size_t>(std::thread::hardware_concurrency(), 1);
+#endif
+	}
+
+	void Platform::message(const Dbg level, const std::string& where, const std::string& message) {
+		_logger.log(level, where, message);
+	}
+
 	void Platform::screenSwap() {
 		// By default do nothing since most platforms don't have two screens.
 	}
 
+	unsigned Platform::getMaxSamples() const {
+		return 0;
+	}
+
+	void Platform::setSamples(unsigned) {
+		// Nothing to change where the game does not choose
+	}
+
 	Supports Platform::supports() {
 		// By default support everything. Individual platforms can turn features off.
 		return Supports::FILESYSTEM | Supports::SHADOWS;
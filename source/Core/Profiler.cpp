@@ -0,0 +1,157 @@
+#include "Core/Profiler.hpp"
+
+#include "Core/Platform.hpp"
+
+#include <cstdio>
+
+namespace SuperHaxagon {
+	static float toMs(const std::chrono::steady_clock::duration duration) {
+		return std::chrono::duration<float, std::milli>(duration).count();
+	}
+
+	static Allocations::Count since(const Allocations::Count& start) {
+		const auto now = Allocations::get();
+		return {now.allocs - start.allocs, now.bytes - start.bytes};
+	}
+
+	Profiler::Profiler(Platform& platform) : _platform(platform) {}
+
+	void Profiler::enter(const Zone zone) {
+		if (_depth < MAX_DEPTH) _open[_depth] = {zone, Clock::now(), 0.0f, Allocations::get(), {0, 0}};
+		_depth++;
+	}
+
+	void Profiler::leave() {
+		if (_depth == 0) return;
+		if (--_depth >= MAX_DEPTH) return;
+
+		const auto& open = _open[_depth];
+		const auto elapsed = toMs(Clock::now() - open.start);
+		const auto index = static_cast<size_t>(open.zone);
+		_current.self[index] += elapsed - open.inner;
+		_current.calls[index]++;
+
+		// Allocations are split up the same way as time
+		const auto allocated = since(open.allocated);
+		_current.selfAllocs[index] += static_cast<uint32_t>(allocated.allocs - open.innerAllocated.allocs);
+		_current.selfAllocBytes[index] += static_cast<uint32_t>(allocated.bytes - open.innerAllocated.bytes);
+
+		// There are far too many polygons to be worth a span each
+		if (open.zone != Zone::DRAW_POLY && _trace.isRecording()) {
+			_trace.span(Trace::Track::GAME, getName(open.zone), Trace::toMicros(open.start), Trace::now());
+		}
+
+		// The outer zone only keeps what is left over
+		if (_depth > 0) {
+			auto& outer = _open[_depth - 1];
+			outer.inner += elapsed;
+			outer.innerAllocated.allocs += allocated.allocs;
+			outer.innerAllocated.bytes += allocated.bytes;
+		} else {
+			_current.busy += elapsed;
+		}
+	}
+
+	void Profiler::frame() {
+		const auto now = Clock::now();
+		if (_start != Clock::time_point{}) {
+			_current.number = _finished;
+			_current.total = toMs(now - _start);
+			const auto allocated = since(_startAllocated);
+			_current.allocs = static_cast<uint32_t>(allocated.allocs);
+			_current.allocBytes = static_cast<uint32_t>(allocated.bytes);
+			if (_trace.isRecording()) {
+				char detail[Trace::DETAIL];
+				std::snprintf(detail, sizeof(detail), "%u", static_cast<unsigned>(_current.number));
+				_trace.span(Trace::Track::GAME, "frame", Trace::toMicros(_start), Trace::toMicros(now), detail);
+			}
+
+			_frames[_finished++ % FRAMES] = _current;
+			if (_current.total > BUDGET_MS * HITCH) {
+				_hitches++;
+				report(_current);
+			}
+		}
+
+		_current = Frame{};
+		_start = now;
+		_startAllocated = Allocations::get();
+	}
+
+	const Profiler::Frame* Profiler::getFrame(const size_t ago) const {
+		if (ago >= FRAMES || ago >= _finished) return nullptr;
+		return &_frames[(_finished - 1 - ago) % FRAMES];
+	}
+
+	const char* Profiler::getName(const Zone zone) {
+		switch (zone) {
+		case Zone::UPDATE: return "update";
+		case Zone::DRAW_TOP: return "draw top";
+		case Zone::DRAW_BOT: return "draw bot";
+		case Zone::LEVEL_UPDATE: return "level update";
+		case Zone::LEVEL_COLLISION: return "level collision";
+		case Zone::LEVEL_DRAW: return "level draw";
+		case Zone::DRAW_POLY: return "draw poly";
+		case Zone::FINALIZE: return "finalize";
+		case Zone::COUNT: break;
+		}
+
+		return "?";
+	}
+
+	void Profiler::report(const Frame& frame) const {
+		if (!_platform.isLogged(Dbg::WARN)) return;
+
+		// Whatever ran outside every zone gets the blame if it was the biggest
+		auto worst = ZONES;
+		auto worstMs = frame.total - frame.busy;
+		for (size_t i = 0; i < ZONES; i++) {
+			if (frame.self[i] <= worstMs) continue;
+			worst = i;
+			worstMs = frame.self[i];
+		}
+
+		char line[128];
+		if (worst == ZONES) {
+			std::snprintf(line, sizeof(line), "frame %u took %.1f ms, %.1f ms outside zones",
+				static_cast<unsigned>(frame.number), frame.total, worstMs);
+		} else {
+			std::snprintf(line, sizeof(line), "frame %u took %.1f ms, %s %.1f ms over %u calls",
+				static_cast<unsigned>(frame.number), frame.total, getName(static_cast<Zone>(worst)), worstMs,
+				static_cast<unsigned>(frame.calls[worst]));
+		}
+
+		_platform.message(Dbg::WARN, "profiler", line);
+	}
+
+	void Profiler::reportAllocations(const Frame& frame) {
+		if (!_platform.isLogged(Dbg::WARN)) return;
+
+		uint32_t zoned = 0;
+		for (const auto allocs : frame.selfAllocs) zoned += allocs;
+
+		// Same as above, whatever was outside every zone can get the blame
+		auto worst = ZONES;
+		auto worstAllocs = frame.allocs - zoned;
+		for (size_t i = 0; i < ZONES; i++) {
+			if (frame.selfAllocs[i] <= worstAllocs) continue;
+			worst = i;
+			worstAllocs = frame.selfAllocs[i];
+		}
+
+		char line[128];
+		if (worst == ZONES) {
+			std::snprintf(line, sizeof(line), "frame %u allocated %u times, %u bytes, outside zones",
+				static_cast<unsigned>(frame.number), static_cast<unsigned>(frame.allocs), static_cast<unsigned>(frame.allocBytes));
+		} else {
+			std::snprintf(line, sizeof(line), "frame %u allocated %u times, %u bytes, %s %u times",
+				static_cast<unsigned>(frame.number), static_cast<unsigned>(frame.allocs), static_cast<unsigned>(frame.allocBytes),
+				getName(static_cast<Zone>(worst)), static_cast<unsigned>(worstAllocs));
+		}
+
+		_platform.message(Dbg::WARN, "alloc", line);
+
+		// Logging allocates as well, which is not the next frame's fault
+		if (_depth == 0) _startAllocated = Allocations::get();
+	}
+}
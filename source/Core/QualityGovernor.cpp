@@ -0,0 +1,128 @@
+#include "Core/QualityGovernor.hpp"
+
+#include "Core/Platform.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <numeric>
+
+namespace SuperHaxagon {
+	static const char* getName(const Quality quality) {
+		switch (quality) {
+		case Quality::FULL: return "full";
+		case Quality::FEWER_SAMPLES: return "fewer antialiasing samples";
+		case Quality::NO_SAMPLES: return "no antialiasing";
+		case Quality::NO_SHADOWS: return "no shadows";
+		case Quality::FLAT_BACKGROUND: return "flat background";
+		case Quality::PLAIN_TEXT: return "plain text";
+		}
+
+		return "?";
+	}
+
+	static float average(const std::array<float, QualityGovernor::WINDOW>& window) {
+		return std::accumulate(window.begin(), window.end(), 0.0f) / static_cast<float>(window.size());
+	}
+
+	QualityGovernor::QualityGovernor(Platform& platform) : _platform(platform) {
+		_samples = _platform.getMaxSamples();
+		restart();
+	}
+
+	void QualityGovernor::frame(const float interval, const float work) {
+		if (_settle > 0) {
+			_settle--;
+			return;
+		}
+
+		if (_raised) _sinceRaise++;
+		_intervals[_next] = interval;
+		_work[_next] = work;
+		_next = (_next + 1) % WINDOW;
+		if (_filled < WINDOW) {
+			_filled++;
+			return;
+		}
+
+		const auto meanInterval = average(_intervals);
+		const auto meanWork = average(_work);
+		if (meanInterval > BUDGET * OVER) {
+			change(false, meanInterval, meanWork);
+			return;
+		}
+
+		if (meanInterval > BUDGET * ON_TIME || meanWork > BUDGET * HEADROOM) {
+			_spare = 0;
+			return;
+		}
+
+		if (++_spare >= _raiseFrames) change(true, meanInterval, meanWork);
+	}
+
+	void QualityGovernor::settle() {
+		if (_samples > 0) _platform.setSamples(getSamples());
+		restart();
+	}
+
+	void QualityGovernor::restart() {
+		_settle = SETTLE_FRAMES;
+		_filled = 0;
+		_next = 0;
+		_spare = 0;
+	}
+
+	bool QualityGovernor::hasShadows() const {
+		return static_cast<int>(_platform.supports() & Supports::SHADOWS) && _quality < Quality::NO_SHADOWS;
+	}
+
+	bool QualityGovernor::applies(const Quality quality) const {
+		switch (quality) {
+		case Quality::FEWER_SAMPLES: return _samples >= 4;
+		case Quality::NO_SAMPLES: return _samples > 0;
+		case Quality::NO_SHADOWS: return static_cast<int>(_platform.supports() & Supports::SHADOWS);
+		default: return true;
+		}
+	}
+
+	unsigned QualityGovernor::getSamples() const {
+		if (_quality >= Quality::NO_SAMPLES) return 0;
+		if (_quality == Quality::FEWER_SAMPLES) return _samples / 2;
+		return _samples;
+	}
+
+	void QualityGovernor::change(const bool up, const float interval, const float work) {
+		auto next = static_cast<int>(_quality);
+		do {
+			next += up ? -1 : 1;
+			if (next < static_cast<int>(Quality::FULL) || next > static_cast<int>(Quality::PLAIN_TEXT)) {
+				// Nowhere left to go, so only look again after a while
+				restart();
+				return;
+			}
+		} while (!applies(static_cast<Quality>(next)));
+
+		if (!up) {
+			// Going back down soon after going up means there was not
+			// really room, so wait longer before trying again
+			const auto failed = _raised && _sinceRaise < FAILED_FRAMES;
+			_raiseFrames = failed ? std::min(_raiseFrames * 2, MAX_RAISE_FRAMES) : RAISE_FRAMES;
+		}
+
+		_quality = static_cast<Quality>(next);
+		_raised = up;
+		_sinceRaise = 0;
+
+		if (_platform.isLogged(Dbg::INFO)) {
+			char line[160];
+			if (up) {
+				std::snprintf(line, sizeof(line), "frames took %.1f ms with %.1f ms of work, raising to %s", interval * 1000.0f, work * 1000.0f, getName(_quality));
+			} else {
+				std::snprintf(line, sizeof(line), "frames took %.1f ms against %.1f ms, lowering to %s, next raise after %u frames", interval * 1000.0f, BUDGET * 1000.0f, getName(_quality), static_cast<unsigned>(_raiseFrames));
+			}
+
+			_platform.message(Dbg::INFO, "quality", line);
+		}
+
+		restart();
+	}
+}
@@ -0,0 +1,161 @@
+#include "Core/ScoreTable.hpp"
+
+#include "Core/Platform.hpp"
+
+#ifdef SUPER_HAXAGON_SHARED_SCORES
+#include <atomic>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace SuperHaxagon {
+#ifndef SUPER_HAXAGON_SHARED_SCORES
+	struct ScoreTable::Slot {};
+
+	ScoreTable::Lock::Lock(ScoreTable& table) : _table(table) {}
+	ScoreTable::Lock::~Lock() = default;
+
+	ScoreTable::~ScoreTable() = default;
+
+	bool ScoreTable::open(const std::string&, Platform&) {
+		return false;
+	}
+
+	int ScoreTable::get(uint64_t) const {
+		return 0;
+	}
+
+	void ScoreTable::raise(uint64_t, int) {}
+
+	void ScoreTable::collect(std::unordered_map<uint64_t, int32_t>&) const {}
+
+	ScoreTable::Slot* ScoreTable::find(uint64_t, bool) const {
+		return nullptr;
+	}
+#else
+	// An id of 0 marks an empty slot
+	struct ScoreTable::Slot {
+		std::atomic<uint64_t> id;
+		std::atomic<int32_t> score;
+		int32_t padding;
+	};
+
+	struct Header {
+		char magic[8];
+		uint32_t capacity;
+		uint32_t slotSize;
+	};
+
+	static_assert(std::atomic<uint64_t>::is_always_lock_free, "score slots must be lock free to be shared");
+	static_assert(std::atomic<int32_t>::is_always_lock_free, "score slots must be lock free to be shared");
+	static constexpr char TABLE_MAGIC[8] = "SCSHM1";
+
+	ScoreTable::Lock::Lock(ScoreTable& table) : _table(table) {
+		if (_table._fd >= 0) flock(_table._fd, LOCK_EX);
+	}
+
+	ScoreTable::Lock::~Lock() {
+		if (_table._fd >= 0) flock(_table._fd, LOCK_UN);
+	}
+
+	ScoreTable::~ScoreTable() {
+		if (_map) munmap(_map, _size);
+		if (_fd >= 0) close(_fd);
+	}
+
+	bool ScoreTable::open(const std::string& path, Platform& platform) {
+		_fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+		if (_fd < 0) {
+			platform.message(Dbg::WARN, "table", "cannot open shared score table");
+			return false;
+		}
+
+		_size = sizeof(Header) + CAPACITY * sizeof(Slot);
+
+		{
+			// Only one process gets to create the table
+			Lock lock(*this);
+
+			struct stat info{};
+			auto valid = fstat(_fd, &info) == 0;
+			if (valid && info.st_size == 0) {
+				Header header{};
+				std::memcpy(header.magic, TABLE_MAGIC, sizeof(TABLE_MAGIC));
+				header.capacity = CAPACITY;
+				header.slotSize = sizeof(Slot);
+
+				// New space in the file reads back as zero, which is an empty slot
+				valid = ftruncate(_fd, static_cast<off_t>(_size)) == 0 && pwrite(_fd, &header, sizeof(header), 0) == sizeof(header);
+			} else if (valid) {
+				Header header{};
+				valid = static_cast<size_t>(info.st_size) == _size && pread(_fd, &header, sizeof(header), 0) == sizeof(header);
+				valid = valid && std::memcmp(header.magic, TABLE_MAGIC, sizeof(TABLE_MAGIC)) == 0 && header.capacity == CAPACITY && header.slotSize == sizeof(Slot);
+			}
+
+			if (valid) {
+				_map = mmap(nullptr, _size, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+				if (_map == MAP_FAILED) _map = nullptr;
+			}
+		}
+
+		if (!_map) {
+			platform.message(Dbg::WARN, "table", "shared score table is unusable, scores stay local");
+			close(_fd);
+			_fd = -1;
+			return false;
+		}
+
+		_slots = reinterpret_cast<Slot*>(static_cast<char*>(_map) + sizeof(Header));
+		platform.message(Dbg::INFO, "table", "mapped shared score table");
+		return true;
+	}
+
+	int ScoreTable::get(const uint64_t id) const {
+		const auto* slot = find(id, false);
+		return slot ? slot->score.load(std::memory_order_acquire) : 0;
+	}
+
+	void ScoreTable::raise(const uint64_t id, const int score) {
+		auto* slot = find(id, true);
+		if (!slot) return;
+
+		auto current = slot->score.load(std::memory_order_acquire);
+		while (score > current && !slot->score.compare_exchange_weak(current, score, std::memory_order_acq_rel)) {}
+	}
+
+	void ScoreTable::collect(std::unordered_map<uint64_t, int32_t>& scores) const {
+		if (!_slots) return;
+		for (uint32_t i = 0; i < CAPACITY; i++) {
+			const auto id = _slots[i].id.load(std::memory_order_acquire);
+			if (!id) continue;
+
+			const auto score = _slots[i].score.load(std::memory_order_acquire);
+			auto& high = scores[id];
+			if (score > high) high = score;
+		}
+	}
+
+	ScoreTable::Slot* ScoreTable::find(const uint64_t id, const bool claim) const {
+		if (!_slots || !id) return nullptr;
+
+		// Linear probing, with a slot's id never changing once it is claimed
+		for (uint32_t probe = 0; probe < CAPACITY; probe++) {
+			auto& slot = _slots[(id + probe) & (CAPACITY - 1)];
+			auto current = slot.id.load(std::memory_order_acquire);
+			if (current == id) return &slot;
+			if (current != 0) continue;
+			if (!claim) return nullptr;
+
+			// Another process may claim the slot first, possibly for this id
+			if (slot.id.compare_exchange_strong(current, id, std::memory_order_acq_rel) || current == id) return &slot;
+		}
+
+		return nullptr;
+	}
+#endif
+}
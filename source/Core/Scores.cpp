@@ -0,0 +1,228 @@
+#include "Core/Scores.hpp"
+
+#include "Core/Game.hpp"
+#include "Core/Platform.hpp"
+#include "Factories/LevelFactory.hpp"
+
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <memory>
+
+namespace SuperHaxagon {
+	const char* Scores::SCORE_HEADER = "SCDB2.0";
+	const char* Scores::SCORE_HEADER_LEGACY = "SCDB1.0";
+	const char* Scores::SCORE_FOOTER = "ENDSCDB";
+
+	Scores::Scores(Game& game) :
+		_platform(game.getPlatform()),
+		_pathDatabase(_platform.getPath("/scores.db", Location::USER)),
+		_pathTemporary(_platform.getPath("/scores.db.tmp", Location::USER)),
+		_pathJournal(_platform.getPath("/scores.journal", Location::USER)),
+		_pathTable(_platform.getPath("/scores.shm", Location::USER)) {}
+
+	Scores::~Scores() = default;
+
+	bool Scores::load() {
+		std::ifstream database(_pathDatabase, std::ios::in | std::ios::binary);
+		if (!loadDatabase(database)) return false;
+
+		// Replayed entries still need to be folded into the database
+		std::ifstream journal(_pathJournal, std::ios::in | std::ios::binary);
+		_journalEntries += loadJournal(journal);
+
+		// Raising is idempotent, so every process can merge what it read
+		if (_table.open(_pathTable, _platform)) {
+			for (const auto& score : _scores) _table.raise(score.first, score.second);
+		}
+
+		return true;
+	}
+
+	int Scores::get(const uint64_t id) const {
+		const auto it = _scores.find(id);
+		const auto local = it == _scores.end() ? 0 : it->second;
+		return std::max(local, _table.get(id));
+	}
+
+	bool Scores::set(const uint64_t id, const int score) {
+		const auto high = score > get(id);
+		if (high) _scores[id] = score;
+		_table.raise(id, score);
+		return high;
+	}
+
+	void Scores::record(const uint64_t id) {
+		char buffer[RECORD_SIZE];
+		packRecord(buffer, {id, get(id)});
+		const std::string record(buffer, RECORD_SIZE);
+		auto path = _pathJournal;
+		_worker.push([path, record] {
+			std::ofstream journal(path, std::ios::out | std::ios::binary | std::ios::app);
+			if (!journal) return;
+			journal.write(record.data(), record.size());
+		});
+
+		if (++_journalEntries >= COMPACT_AFTER) compact();
+	}
+
+	void Scores::compact() {
+		if (_journalEntries == 0) return;
+		_journalEntries = 0;
+
+		// Snapshot the scores now. Anything recorded after this point is
+		// queued behind the compaction and lands in a fresh journal.
+		auto snapshot = _scores;
+		auto* table = &_table;
+		auto database = _pathDatabase;
+		auto temporary = _pathTemporary;
+		auto journal = _pathJournal;
+		_worker.push([database, temporary, journal, table, snapshot]() mutable {
+			// Other processes compact into the same file, one at a time
+			ScoreTable::Lock lock(*table);
+			table->collect(snapshot);
+
+			std::string records(snapshot.size() * RECORD_SIZE, '\0');
+			auto* out = &records[0];
+			for (const auto& score : snapshot) {
+				packRecord(out, score);
+				out += RECORD_SIZE;
+			}
+
+			{
+				std::ofstream scores(temporary, std::ios::out | std::ios::binary | std::ios::trunc);
+				if (!scores) return;
+
+				auto count = static_cast<uint32_t>(snapshot.size());
+				scores.write(SCORE_HEADER, strlen(SCORE_HEADER));
+				scores.write(reinterpret_cast<char*>(&count), sizeof(count));
+				scores.write(records.data(), records.size());
+				scores.write(SCORE_FOOTER, strlen(SCORE_FOOTER));
+
+				scores.flush();
+				if (!scores) return;
+			}
+
+			// Some platforms refuse to rename over an existing file
+			if (std::rename(temporary.c_str(), database.c_str()) != 0) {
+				std::remove(database.c_str());
+				if (std::rename(temporary.c_str(), database.c_str()) != 0) return;
+			}
+
+			// Only drop the journal once the database has everything in it
+			std::remove(journal.c_str());
+		});
+	}
+
+	void Scores::packRecord(char* buffer, const Record& record) {
+		std::memcpy(buffer, &record.first, sizeof(record.first));
+		std::memcpy(buffer + sizeof(record.first), &record.second, sizeof(record.second));
+	}
+
+	Scores::Record Scores::unpackRecord(const char* buffer) {
+		Record record;
+		std::memcpy(&record.first, buffer, sizeof(record.first));
+		std::memcpy(&record.second, buffer + sizeof(record.first), sizeof(record.second));
+		return record;
+	}
+
+	bool Scores::loadDatabase(std::istream& stream) {
+		if (!stream) {
+			_platform.message(Dbg::INFO, "scores", "no score database");
+			return true;
+		}
+
+		const auto header = std::make_unique<char[]>(strlen(SCORE_HEADER) + 1);
+		stream.read(header.get(), strlen(SCORE_HEADER));
+		header[strlen(SCORE_HEADER)] = '\0';
+		if (header.get() == std::string(SCORE_HEADER_LEGACY)) return loadLegacy(stream);
+		if (header.get() != std::string(SCORE_HEADER)) {
+			_platform.message(Dbg::WARN,"scores", "score header invalid, skipping scores");
+			return true; // If there is no score database silently fail.
+		}
+
+		const auto numScores = static_cast<size_t>(read32(stream, 0, INT_MAX, _platform, "number of scores"));
+
+		// Make sure the file is actually that long before allocating for it
+		const auto start = stream.tellg();
+		stream.seekg(0, std::ios::end);
+		const auto available = static_cast<size_t>(stream.tellg() - start);
+		stream.seekg(start);
+		if (!stream || available < numScores * RECORD_SIZE) {
+			_platform.message(Dbg::WARN,"scores", "file truncated, db broken");
+			return false;
+		}
+
+		// Everything is read in one go, then split up in memory
+		std::string records(numScores * RECORD_SIZE, '\0');
+		stream.read(&records[0], records.size());
+		_scores.reserve(numScores);
+		for (size_t i = 0; i < numScores; i++) {
+			const auto record = unpackRecord(records.data() + i * RECORD_SIZE);
+			auto& high = _scores[record.first];
+			if (record.second > high) high = record.second;
+		}
+
+		if (!readCompare(stream, SCORE_FOOTER)) {
+			_platform.message(Dbg::WARN,"scores", "file footer invalid, db broken");
+			return false;
+		}
+
+		return true;
+	}
+
+	bool Scores::loadLegacy(std::istream& stream) {
+		// SCDB1.0 stored the level strings. They are hashed into ids
+		// and the database is upgraded the next time it is compacted.
+		const auto numScores = read32(stream, 0, INT_MAX, _platform, "number of scores");
+		for (auto i = 0; i < numScores && stream; i++) {
+			const auto name = readString(stream, _platform, "score level name");
+			const auto difficulty = readString(stream, _platform, "score level difficulty");
+			const auto mode = readString(stream, _platform, "score level mode");
+			const auto creator = readString(stream, _platform, "score level creator");
+			const auto score = read32(stream, 0, INT_MAX, _platform, "score");
+			set(LevelFactory::makeId(name, difficulty, mode, creator), score);
+		}
+
+		if (!readCompare(stream, SCORE_FOOTER)) {
+			_platform.message(Dbg::WARN,"scores", "file footer invalid, db broken");
+			return false;
+		}
+
+		_platform.message(Dbg::INFO, "scores", "upgrading legacy score database");
+		_journalEntries++;
+		return true;
+	}
+
+	int Scores::loadJournal(std::istream& stream) {
+		if (!stream) return 0;
+
+		const std::string records((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+
+		// A crash while appending leaves a short record at the end. It is
+		// cut off before anything else is appended, as every later record
+		// would otherwise start part way into one.
+		const auto replayed = records.size() / RECORD_SIZE;
+		if (records.size() % RECORD_SIZE) {
+			_platform.message(Dbg::WARN, "scores", "journal has a torn record, cutting it off");
+			auto path = _pathJournal;
+			auto whole = records.substr(0, replayed * RECORD_SIZE);
+			_worker.push([path, whole] {
+				std::ofstream journal(path, std::ios::out | std::ios::binary | std::ios::trunc);
+				if (!journal) return;
+				journal.write(whole.data(), whole.size());
+			});
+		}
+
+		for (size_t i = 0; i < replayed; i++) {
+			const auto record = unpackRecord(records.data() + i * RECORD_SIZE);
+			set(record.first, record.second);
+		}
+
+		if (_platform.isLogged(Dbg::INFO)) _platform.message(Dbg::INFO, "scores", "replayed " + std::to_string(replayed) + " journal entries");
+		return static_cast<int>(replayed);
+	}
+}
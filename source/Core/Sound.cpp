@@ -0,0 +1,248 @@
+#include "Core/Sound.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <istream>
+#include <ostream>
+
+namespace SuperHaxagon {
+	// Sound effects are tiny, anything bigger than this is not one
+	static constexpr uint32_t MAX_DATA = 64 * 1024 * 1024;
+
+	static constexpr int FORMAT_PCM = 1;
+	static constexpr int FORMAT_IMA_ADPCM = 0x11;
+
+	static constexpr std::array<int16_t, 89> ADPCM_STEPS{
+		7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+		50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209, 230,
+		253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876, 963,
+		1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327,
+		3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442,
+		11487, 12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794,
+		32767
+	};
+
+	static constexpr std::array<int, 8> ADPCM_INDEX{-1, -1, -1, -1, 2, 4, 6, 8};
+
+	// What one channel's decoder knows at any point
+	struct AdpcmState {
+		int predictor = 0;
+		int index = 0;
+
+		int decode(const int nibble) {
+			const auto step = ADPCM_STEPS[index];
+			auto delta = step >> 3;
+			if (nibble & 4) delta += step;
+			if (nibble & 2) delta += step >> 1;
+			if (nibble & 1) delta += step >> 2;
+			predictor = std::max(-32768, std::min(32767, predictor + (nibble & 8 ? -delta : delta)));
+			index = std::max(0, std::min(static_cast<int>(ADPCM_STEPS.size()) - 1, index + ADPCM_INDEX[nibble & 7]));
+			return predictor;
+		}
+
+		int encode(const int sample) {
+			auto diff = sample - predictor;
+			auto nibble = 0;
+			if (diff < 0) {
+				nibble = 8;
+				diff = -diff;
+			}
+
+			// Same steps as decoding, so both sides stay in sync
+			auto step = static_cast<int>(ADPCM_STEPS[index]);
+			for (auto bit = 4; bit; bit >>= 1, step >>= 1) {
+				if (diff < step) continue;
+				nibble |= bit;
+				diff -= step;
+			}
+
+			decode(nibble);
+			return nibble;
+		}
+	};
+
+	static uint32_t readLittle(const unsigned char* data, const int bytes) {
+		uint32_t value = 0;
+		for (auto i = bytes - 1; i >= 0; i--) value = (value << 8) | data[i];
+		return value;
+	}
+
+	static void writeLittle(std::ostream& stream, const uint32_t value, const int bytes) {
+		for (auto i = 0; i < bytes; i++) stream.put(static_cast<char>((value >> (8 * i)) & 0xFF));
+	}
+
+	std::unique_ptr<Sound> loadWav(std::istream& stream) {
+		unsigned char riff[12];
+		if (!stream.read(reinterpret_cast<char*>(riff), sizeof(riff))) return nullptr;
+		if (std::memcmp(riff, "RIFF", 4) != 0 || std::memcmp(riff + 8, "WAVE", 4) != 0) return nullptr;
+
+		auto sound = std::make_unique<Sound>();
+		auto bits = 0;
+		auto format = 0;
+		size_t align = 0;
+		size_t fact = 0;
+		unsigned char chunk[8];
+		while (stream.read(reinterpret_cast<char*>(chunk), sizeof(chunk))) {
+			const auto size = readLittle(chunk + 4, 4);
+			if (std::memcmp(chunk, "fmt ", 4) == 0) {
+				unsigned char fmt[16];
+				if (size < sizeof(fmt) || !stream.read(reinterpret_cast<char*>(fmt), sizeof(fmt))) return nullptr;
+				format = static_cast<int>(readLittle(fmt, 2));
+				sound->channels = static_cast<int>(readLittle(fmt + 2, 2));
+				sound->rate = static_cast<int>(readLittle(fmt + 4, 4));
+				align = readLittle(fmt + 12, 2);
+				bits = static_cast<int>(readLittle(fmt + 14, 2));
+				stream.ignore(size - sizeof(fmt) + (size & 1));
+			} else if (std::memcmp(chunk, "fact", 4) == 0 && size >= 4) {
+				// Compressed files say how many frames there really are
+				unsigned char frames[4];
+				if (!stream.read(reinterpret_cast<char*>(frames), sizeof(frames))) return nullptr;
+				fact = readLittle(frames, 4);
+				stream.ignore(size - sizeof(frames) + (size & 1));
+			} else if (std::memcmp(chunk, "data", 4) == 0) {
+				// The format has to come first to make sense of the data
+				if (sound->channels < 1 || sound->channels > 2 || sound->rate <= 0) return nullptr;
+				if (format == FORMAT_IMA_ADPCM) {
+					const auto group = static_cast<size_t>(4 * sound->channels);
+					if (bits != 4 || align <= group || align % group || align > Sound::MAX_ALIGN) return nullptr;
+
+					sound->adpcm.resize(std::min(size, MAX_DATA));
+					stream.read(reinterpret_cast<char*>(sound->adpcm.data()), sound->adpcm.size());
+					sound->adpcm.resize(static_cast<size_t>(stream.gcount()));
+					sound->adpcmAlign = align;
+
+					// The last block may be cut short. Written out it is padded to
+					// a whole group, so anything past the last whole one is a torn file.
+					const auto last = sound->adpcm.size() % align / group * group;
+					sound->adpcmFrames = sound->adpcm.size() / align * sound->getBlockFrames();
+					if (last >= group) sound->adpcmFrames += (last - group) * 2 / sound->channels + 1;
+					if (fact) sound->adpcmFrames = std::min(sound->adpcmFrames, fact);
+					if (!sound->adpcmFrames) return nullptr;
+					return sound;
+				}
+
+				if (format != FORMAT_PCM || (bits != 8 && bits != 16)) return nullptr;
+
+				std::vector<unsigned char> data(std::min(size, MAX_DATA));
+				stream.read(reinterpret_cast<char*>(data.data()), data.size());
+				data.resize(static_cast<size_t>(stream.gcount()));
+
+				// 8 bit samples are unsigned, 16 bit ones are signed
+				const auto width = static_cast<size_t>(bits / 8);
+				sound->samples.resize(data.size() / width);
+				for (size_t i = 0; i < sound->samples.size(); i++) {
+					sound->samples[i] = bits == 8 ?
+						static_cast<int16_t>((data[i] - 128) * 256) :
+						static_cast<int16_t>(readLittle(&data[i * 2], 2));
+				}
+
+				return sound;
+			} else {
+				// Chunks are padded to an even length
+				stream.ignore(size + (size & 1));
+			}
+		}
+
+		return nullptr;
+	}
+
+	std::unique_ptr<Sound> compressAdpcm(const Sound& sound, const size_t blockAlign) {
+		const auto channels = static_cast<size_t>(sound.channels);
+		const auto group = 4 * channels;
+		if (sound.isCompressed() || !sound.getFrames() || channels > 2 || blockAlign <= group || blockAlign % group || blockAlign > Sound::MAX_ALIGN) return nullptr;
+
+		auto compressed = std::make_unique<Sound>();
+		compressed->rate = sound.rate;
+		compressed->channels = sound.channels;
+		compressed->adpcmAlign = blockAlign;
+		compressed->adpcmFrames = sound.getFrames();
+
+		const auto blockFrames = compressed->getBlockFrames();
+		const auto blocks = (sound.getFrames() + blockFrames - 1) / blockFrames;
+		compressed->adpcm.reserve(blocks * blockAlign);
+
+		// The step size carries over between blocks, the prediction restarts from each header
+		std::array<AdpcmState, 2> states{};
+		const auto sample = [&sound, channels](const size_t frame, const size_t channel) {
+			const auto clamped = std::min(frame, sound.getFrames() - 1);
+			return static_cast<int>(sound.samples[clamped * channels + channel]);
+		};
+
+		for (size_t block = 0; block < blocks; block++) {
+			const auto first = block * blockFrames;
+			const auto frames = std::min(blockFrames, sound.getFrames() - first);
+			for (size_t c = 0; c < channels; c++) {
+				auto& state = states[c];
+				state.predictor = sample(first, c);
+				const auto header = static_cast<uint16_t>(static_cast<int16_t>(state.predictor));
+				compressed->adpcm.push_back(static_cast<uint8_t>(header & 0xFF));
+				compressed->adpcm.push_back(static_cast<uint8_t>(header >> 8));
+				compressed->adpcm.push_back(static_cast<uint8_t>(state.index));
+				compressed->adpcm.push_back(0);
+			}
+
+			// Groups of 8 frames, 4 bytes per channel, low nibble first.
+			// The last block is only as long as it needs to be.
+			for (size_t frame = 1; frame < frames; frame += 8) {
+				for (size_t c = 0; c < channels; c++) {
+					for (size_t i = 0; i < 8; i += 2) {
+						const auto low = states[c].encode(sample(first + frame + i, c));
+						const auto high = states[c].encode(sample(first + frame + i + 1, c));
+						compressed->adpcm.push_back(static_cast<uint8_t>(low | high << 4));
+					}
+				}
+			}
+		}
+
+		return compressed;
+	}
+
+	size_t decodeAdpcm(const Sound& sound, const size_t block, int16_t* out) {
+		const auto channels = static_cast<size_t>(sound.channels);
+		const auto blockFrames = sound.getBlockFrames();
+		const auto first = block * blockFrames;
+		if (first >= sound.adpcmFrames) return 0;
+
+		const auto frames = std::min(blockFrames, sound.adpcmFrames - first);
+		const auto* data = sound.adpcm.data() + block * sound.adpcmAlign;
+		std::array<AdpcmState, 2> states{};
+		for (size_t c = 0; c < channels; c++) {
+			states[c].predictor = static_cast<int16_t>(readLittle(data, 2));
+			states[c].index = std::min(static_cast<int>(data[2]), static_cast<int>(ADPCM_STEPS.size()) - 1);
+			out[c] = static_cast<int16_t>(states[c].predictor);
+			data += 4;
+		}
+
+		for (size_t frame = 1; frame < frames; frame += 8) {
+			for (size_t c = 0; c < channels; c++) {
+				for (size_t i = 0; i < 8; i++) {
+					const auto nibble = i & 1 ? data[i / 2] >> 4 : data[i / 2] & 0xF;
+					const auto value = states[c].decode(nibble);
+					if (frame + i < frames) out[(frame + i) * channels + c] = static_cast<int16_t>(value);
+				}
+
+				data += 4;
+			}
+		}
+
+		return frames;
+	}
+
+	void writeWavHeader(std::ostream& stream, const int rate, const int channels, const uint32_t frames) {
+		const auto align = static_cast<uint32_t>(channels * 2);
+		const auto bytes = frames * align;
+		stream.write("RIFF", 4);
+		writeLittle(stream, 36 + bytes, 4);
+		stream.write("WAVEfmt ", 8);
+		writeLittle(stream, 16, 4);
+		writeLittle(stream, 1, 2);
+		writeLittle(stream, static_cast<uint32_t>(channels), 2);
+		writeLittle(stream, static_cast<uint32_t>(rate), 4);
+		writeLittle(stream, static_cast<uint32_t>(rate) * align, 4);
+		writeLittle(stream, align, 2);
+		writeLittle(stream, 16, 2);
+		stream.write("data", 4);
+		writeLittle(stream, bytes, 4);
+	}
+}
@@ -0,0 +1,143 @@
+#include "Core/Trace.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <ostream>
+#include <utility>
+
+namespace SuperHaxagon {
+	static const char* getTrackName(const Trace::Track track) {
+		switch (track) {
+		case Trace::Track::GAME: return "game";
+		case Trace::Track::WORKER: return "worker";
+		case Trace::Track::AUDIO: return "audio";
+		case Trace::Track::JOBS: return "jobs";
+		}
+
+		return "?";
+	}
+
+	// Only what a JSON string cannot hold as it is
+	static void writeEscaped(std::ostream& stream, const char* text) {
+		for (; *text; text++) {
+			const auto c = static_cast<unsigned char>(*text);
+			if (c == '"' || c == '\\') {
+				stream << '\\' << *text;
+			} else if (c < 0x20) {
+				stream << ' ';
+			} else {
+				stream << *text;
+			}
+		}
+	}
+
+	void Trace::start() {
+#ifndef SUPER_HAXAGON_NO_THREADS
+		std::lock_guard<std::mutex> lock(_mutex);
+#endif
+		_events.resize(EVENTS);
+		_next = 0;
+		_wrapped = false;
+		_recording.store(true, std::memory_order_relaxed);
+	}
+
+	std::vector<Trace::Event> Trace::stop() {
+#ifndef SUPER_HAXAGON_NO_THREADS
+		std::lock_guard<std::mutex> lock(_mutex);
+#endif
+		_recording.store(false, std::memory_order_relaxed);
+
+		// Unwind the ring so the oldest comes first
+		std::vector<Event> events;
+		if (_wrapped) std::rotate(_events.begin(), _events.begin() + _next, _events.end());
+		else _events.resize(_next);
+		events.swap(_events);
+		return events;
+	}
+
+	void Trace::span(const Track track, const char* name, const uint64_t start, const uint64_t end, const char* detail) {
+		if (!isRecording()) return;
+		Event event{name, {}, start, static_cast<uint32_t>(end > start ? end - start : 0), track, false};
+		std::strncpy(event.detail, detail, DETAIL - 1);
+		push(event);
+	}
+
+	void Trace::span(const Track track, const char* name, const uint64_t start, const uint64_t end, const std::string& detail) {
+		span(track, name, start, end, detail.c_str());
+	}
+
+	void Trace::instant(const Track track, const char* name, const char* detail) {
+		if (!isRecording()) return;
+		Event event{name, {}, now(), 0, track, true};
+		std::strncpy(event.detail, detail, DETAIL - 1);
+		push(event);
+	}
+
+	void Trace::instant(const Track track, const char* name, const std::string& detail) {
+		instant(track, name, detail.c_str());
+	}
+
+	uint64_t Trace::now() {
+		return toMicros(std::chrono::steady_clock::now());
+	}
+
+	uint64_t Trace::toMicros(const std::chrono::steady_clock::time_point time) {
+		using namespace std::chrono;
+		static const auto epoch = steady_clock::now();
+		return static_cast<uint64_t>(duration_cast<microseconds>(time - epoch).count());
+	}
+
+	void Trace::write(std::ostream& stream, const std::vector<Event>& events) {
+		stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+		for (const auto track : {Track::GAME, Track::WORKER, Track::AUDIO, Track::JOBS}) {
+			stream << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << static_cast<int>(track)
+				<< ",\"args\":{\"name\":\"" << getTrackName(track) << "\"}},\n";
+		}
+
+		for (size_t i = 0; i < events.size(); i++) {
+			const auto& event = events[i];
+			stream << "{\"name\":\"";
+			writeEscaped(stream, event.name);
+			stream << "\",\"cat\":\"" << getTrackName(event.track) << "\",\"pid\":1,\"tid\":" << static_cast<int>(event.track)
+				<< ",\"ts\":" << event.start;
+			if (event.instant) stream << ",\"ph\":\"i\",\"s\":\"t\"";
+			else stream << ",\"ph\":\"X\",\"dur\":" << event.duration;
+			if (event.detail[0]) {
+				stream << ",\"args\":{\"detail\":\"";
+				writeEscaped(stream, event.detail);
+				stream << "\"}";
+			}
+
+			stream << (i + 1 < events.size() ? "},\n" : "}\n");
+		}
+
+		stream << "]}\n";
+	}
+
+	void Trace::push(const Event& event) {
+#ifndef SUPER_HAXAGON_NO_THREADS
+		std::lock_guard<std::mutex> lock(_mutex);
+#endif
+		// Stopped while this one was on its way
+		if (_events.empty()) return;
+
+		_events[_next++] = event;
+		if (_next == _events.size()) {
+			_next = 0;
+			_wrapped = true;
+		}
+	}
+
+	TraceSpan::TraceSpan(Trace& trace, const Trace::Track track, const char* name, std::string detail) :
+		_trace(trace),
+		_track(track),
+		_name(name),
+		_detail(std::move(detail)),
+		_recording(trace.isRecording()),
+		_start(_recording ? Trace::now() : 0) {}
+
+	TraceSpan::~TraceSpan() {
+		// A capture that started part way through only gets whole spans
+		if (_recording) _trace.span(_track, _name, _start, Trace::now(), _detail);
+	}
+}
@@ -0,0 +1,87 @@
+#include "Core/VoicePool.hpp"
+
+#include "Core/AudioLoader.hpp"
+#include "Core/AudioPlayer.hpp"
+
+#include <algorithm>
+
+namespace SuperHaxagon {
+	VoicePool::VoicePool(const int voices, const int firstChannel) :
+		_voices(voices),
+		_firstChannel(firstChannel) {}
+
+	VoicePool::~VoicePool() = default;
+
+	bool VoicePool::play(AudioLoader& audio) {
+		const auto index = pick(audio);
+		if (index < 0) return false;
+
+		auto& voice = _voices[index];
+		if (voice.current && !voice.current->isDone()) {
+			// Stolen. Players carry on by themselves on some platforms, so
+			// the one cut off is dropped, which is what stops it everywhere.
+			auto& players = voice.players;
+			players.erase(std::remove_if(players.begin(), players.end(), [&voice](const Player& player) {
+				return player.player.get() == voice.current;
+			}), players.end());
+			voice.current = nullptr;
+		}
+
+		auto* player = voice.find(audio);
+		if (!player) {
+			auto instance = audio.instantiate();
+			if (!instance) return false;
+
+			player = instance.get();
+			player->setChannel(_firstChannel + index);
+			player->setLoop(false);
+			voice.players.push_back({&audio, std::move(instance)});
+		}
+
+		voice.current = player;
+		voice.priority = audio.getPriority();
+		voice.started = ++_played;
+		player->play();
+		return true;
+	}
+
+	void VoicePool::clear() {
+		for (auto& voice : _voices) {
+			voice.current = nullptr;
+			voice.players.clear();
+		}
+	}
+
+	AudioPlayer* VoicePool::Voice::find(const AudioLoader& audio) const {
+		for (const auto& player : players) {
+			if (player.audio == &audio) return player.player.get();
+		}
+
+		return nullptr;
+	}
+
+	int VoicePool::pick(const AudioLoader& audio) const {
+		// In order of preference: an idle voice that already has a player of
+		// the same sound, any idle voice, and finally the least important
+		// sound still playing.
+		auto idle = -1;
+		auto steal = -1;
+		for (auto i = 0; i < static_cast<int>(_voices.size()); i++) {
+			const auto& voice = _voices[i];
+			if (!voice.current || voice.current->isDone()) {
+				if (voice.find(audio)) return i;
+				if (idle < 0 || (voice.players.empty() && !_voices[idle].players.empty())) idle = i;
+				continue;
+			}
+
+			const auto& current = _voices[steal < 0 ? i : steal];
+			if (steal < 0 || voice.priority < current.priority || (voice.priority == current.priority && voice.started < current.started)) {
+				steal = i;
+			}
+		}
+
+		if (idle >= 0) return idle;
+		if (steal >= 0 && _voices[steal].priority <= audio.getPriority()) return steal;
+		return -1;
+	}
+}
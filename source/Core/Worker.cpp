@@ -0,0 +1,63 @@
+#include "Core/Worker.hpp"
+
+namespace SuperHaxagon {
+#ifdef SUPER_HAXAGON_NO_THREADS
+	Worker::Worker() = default;
+	Worker::~Worker() = default;
+
+	void Worker::push(std::function<void()> job) {
+		// No threads, so the caller pays for the job right now.
+		job();
+	}
+
+	void Worker::flush() {}
+
+	void Worker::run() {}
+#else
+	Worker::Worker() : _thread(&Worker::run, this) {}
+
+	Worker::~Worker() {
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_quit = true;
+		}
+
+		// Anything still queued is finished before the thread exits
+		_wake.notify_one();
+		_thread.join();
+	}
+
+	void Worker::push(std::function<void()> job) {
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_jobs.emplace_back(std::move(job));
+		}
+
+		_wake.notify_one();
+	}
+
+	void Worker::flush() {
+		std::unique_lock<std::mutex> lock(_mutex);
+		_idle.wait(lock, [this] {return _jobs.empty() && !_busy;});
+	}
+
+	void Worker::run() {
+		std::unique_lock<std::mutex> lock(_mutex);
+		while (true) {
+			_wake.wait(lock, [this] {return _quit || !_jobs.empty();});
+			if (_jobs.empty()) break;
+
+			auto job = std::move(_jobs.front());
+			_jobs.pop_front();
+			_busy = true;
+
+			lock.unlock();
+			job();
+			lock.lock();
+
+			_busy = false;
+			if (_jobs.empty()) _idle.notify_all();
+		}
+	}
+#endif
+}
@@ -1,6 +1,6 @@
 #include "Driver/3DS/AudioPlayerOgg3DS.hpp"
 
-#include <stb_vorbis.c>
+#include "Core/OggStream.hpp"
 
 namespace SuperHaxagon {
 	const int BUFFER_MS = 200;
@@ -10,16 +10,12 @@ namespace SuperHaxagon {
 	AudioPlayerOgg3DS::AudioPlayerOgg3DS(const std::string& path) {
 		_loaded = false;
 
-		auto error = 0;
-		_oggFile = stb_vorbis_open_filename(path.c_str(), &error, nullptr);
-		if(error || !(_oggFile->channels == 1 || _oggFile->channels == 2)) return;
+		_stream = std::make_unique<OggStream>(path, STREAM_LATENCY_MS);
+		if (!_stream->isOpen()) return;
 
-		const auto bufferSize = getWaveBuffSize(_oggFile->sample_rate, _oggFile->channels) * _waveBuffs.size();
+		const auto bufferSize = getWaveBuffSize(_stream->getRate(), _stream->getChannels()) * _waveBuffs.size();
 		_audioBuffer = static_cast<int16_t*>(linearAlloc(bufferSize));
-		if(!_audioBuffer) {
-			stb_vorbis_close(_oggFile);
-			return;
-		}
+		if(!_audioBuffer) return;
 
 		memset(&_waveBuffs, 0, _waveBuffs.size());
 		auto* buffer = _audioBuffer;
@@ -27,7 +23,7 @@ namespace SuperHaxagon {
 		for(auto& waveBuff : _waveBuffs) {
 			waveBuff.data_vaddr = buffer;
 			waveBuff.status = NDSP_WBUF_DONE;
-			buffer += getWaveBuffSize(_oggFile->sample_rate, _oggFile->channels) / sizeof(buffer[0]);
+			buffer += getWaveBuffSize(_stream->getRate(), _stream->getChannels()) / sizeof(buffer[0]);
 		}
 
 		_loaded = true;
@@ -47,7 +43,6 @@ namespace SuperHaxagon {
 		ndspChnWaveBufClear(_channel);
 		ndspChnReset(_channel);
 		linearFree(_audioBuffer);
-		stb_vorbis_close(_oggFile);
 	}
 
 	void AudioPlayerOgg3DS::setChannel(const int channel) {
@@ -56,23 +51,22 @@ namespace SuperHaxagon {
 
 	void AudioPlayerOgg3DS::setLoop(const bool loop) {
 		_loop = loop;
+		if (_stream) _stream->setLoop(loop);
 	}
 
 	void AudioPlayerOgg3DS::play() {
 		if (!_loaded) return;
 
 		if (_thread) {
-			if (_diff) _start += svcGetSystemTick() - _diff;
 			ndspChnSetPaused(_channel, false);
 			LightEvent_Signal(&_event);
-			_diff = 0;
 			return;
 		}
 
 		ndspChnReset(_channel);
 		ndspChnSetInterp(_channel, NDSP_INTERP_POLYPHASE);
-		ndspChnSetRate(_channel, static_cast<float>(_oggFile->sample_rate));
-		ndspChnSetFormat(_channel, _oggFile->channels == 1 ? NDSP_FORMAT_MONO_PCM16 : NDSP_FORMAT_STEREO_PCM16);
+		ndspChnSetRate(_channel, static_cast<float>(_stream->getRate()));
+		ndspChnSetFormat(_channel, _stream->getChannels() == 1 ? NDSP_FORMAT_MONO_PCM16 : NDSP_FORMAT_STEREO_PCM16);
 
 		int32_t priority = 0x30;
 		svcGetThreadPriority(&priority, CUR_THREAD_HANDLE);
@@ -82,13 +76,12 @@ namespace SuperHaxagon {
 		priority = priority > 0x3F ? 0x3F : priority;
 
 		// Start the thread, passing the player as an argument.
+		_clock.restart();
 		_thread = threadCreate(audioThread, this, THREAD_STACK_SZ, priority, THREAD_AFFINITY, false);
-		_start = svcGetSystemTick();
 	}
 
 	void AudioPlayerOgg3DS::pause() {
 		ndspChnSetPaused(_channel, true);
-		_diff = svcGetSystemTick();
 	}
 
 	bool AudioPlayerOgg3DS::isDone() const {
@@ -97,31 +90,26 @@ namespace SuperHaxagon {
 
 	float AudioPlayerOgg3DS::getTime() const {
 		if (!_loaded) return 0;
-
-		// If we set diff (paused), we are frozen in time. Otherwise, the current timestamp is
-		// the system minus the start of the song.
-		const auto ticks = _diff ? _diff - _start : svcGetSystemTick() - _start;
-		const auto timeMs = static_cast<float>(ticks) / static_cast<float>(CPU_TICKS_PER_MSEC);
-		return timeMs / 1000.0f;
+		return _clock.getTime();
 	}
 
-	bool AudioPlayerOgg3DS::audioDecode(stb_vorbis* file, ndspWaveBuf* buff, const int channel) {
-		long totalSamples = 0;
+	bool AudioPlayerOgg3DS::audioDecode(OggStream& stream, ndspWaveBuf* buff, const int channel) {
+		const auto samplesPerBuff = getSamplesPerBuff(stream.getRate());
+		size_t totalSamples = 0;
 
-		while (totalSamples < static_cast<long>(getSamplesPerBuff(file->sample_rate))) {
-			auto* const buffer = buff->data_pcm16 + (totalSamples * file->channels);
-			const size_t bufferSize = (getSamplesPerBuff(file->sample_rate) - totalSamples) * file->channels;
+		while (totalSamples < samplesPerBuff) {
+			auto* const buffer = buff->data_pcm16 + totalSamples * stream.getChannels();
+			totalSamples += stream.read(buffer, samplesPerBuff - totalSamples);
+			if (totalSamples == samplesPerBuff || stream.isDone()) break;
 
-			const auto samples = stb_vorbis_get_samples_short_interleaved(file, file->channels, buffer, bufferSize);
-			if (samples <= 0) break;
-
-			totalSamples += samples;
+			// The decoder fell behind, give it a millisecond to catch up
+			svcSleepThread(1000000);
 		}
 
 		if (totalSamples == 0) return false;
 		buff->nsamples = totalSamples;
 		ndspChnWaveBufAdd(channel, buff);
-		DSP_FlushDataCache(buff->data_pcm16, totalSamples * file->channels * sizeof(int16_t));
+		DSP_FlushDataCache(buff->data_pcm16, totalSamples * stream.getChannels() * sizeof(int16_t));
 		return true;
 	}
 
@@ -134,25 +122,37 @@ namespace SuperHaxagon {
 		if (!pointer) return;
 
 		while(!pointer->_quit) {
-			for (auto& waveBuff : pointer->_waveBuffs) {
+			for (size_t i = 0; i < pointer->_waveBuffs.size(); i++) {
+				auto& waveBuff = pointer->_waveBuffs[i];
 				if (waveBuff.status != NDSP_WBUF_DONE) continue;
-				if (!audioDecode(pointer->_oggFile, &waveBuff, pointer->_channel)) {
-					if (!pointer->_loop) {
-						pointer->_quit = true;
-						return;
-					}
-
-					// We are looping, so go back to the beginning
-					stb_vorbis_seek_start(pointer->_oggFile);
-					pointer->_start = svcGetSystemTick();
+
+				// The stream loops by itself, so this is already where the buffer starts in the song
+				pointer->_waveBuffTimes[i] = pointer->_stream->getTime();
+				if (!audioDecode(*pointer->_stream, &waveBuff, pointer->_channel)) {
+					pointer->_quit = true;
+					return;
 				}
 			}
 
+			// Woken once per DSP frame, so the clock hears about every few milliseconds
+			pointer->publish();
 			if (pointer->_quit) return;
 			LightEvent_Wait(&_event);
 		}
 	}
 
+	void AudioPlayerOgg3DS::publish() {
+		// Find the buffer the DSP is on and how far into it it is
+		const auto sequence = ndspChnGetWaveBufSeq(_channel);
+		for (size_t i = 0; i < _waveBuffs.size(); i++) {
+			if (_waveBuffs[i].status != NDSP_WBUF_PLAYING || _waveBuffs[i].sequence_id != sequence) continue;
+
+			const auto offset = static_cast<float>(ndspChnGetSamplePos(_channel)) / static_cast<float>(_stream->getRate());
+			_clock.publish(_waveBuffTimes[i] + offset, !ndspChnIsPaused(_channel));
+			return;
+		}
+	}
+
 	unsigned int AudioPlayerOgg3DS::getSamplesPerBuff(const unsigned int sampleRate) {
 		return sampleRate * BUFFER_MS / 1000;
 	}
@@ -16,6 +16,11 @@
 
 namespace SuperHaxagon {
 	Platform3DS::Platform3DS(const Dbg dbg) : Platform(dbg) {
+		// An old 3DS gives apps 64 MB, and the libraries need their share of it
+		_memory.setBudget(MemoryTag::LEVELS, 2 * 1024 * 1024);
+		_memory.setBudget(MemoryTag::PATTERNS, 4 * 1024 * 1024);
+		_memory.setBudget(MemoryTag::AUDIO, 24 * 1024 * 1024);
+
 		romfsInit();
 		gfxInitDefault();
 
@@ -75,8 +80,9 @@ namespace SuperHaxagon {
 		C2D_TargetClear(_top, C2D_Color32(0x00, 0x00, 0x00, 0xff));
 		C2D_SceneBegin(_top);
 
-		if (_dbg == Dbg::FATAL) {
-			// Allowed to draw bottom screen if in fatal mode
+		if (_dbg == Dbg::FATAL || _overlay) {
+			// Allowed to draw bottom screen if in fatal mode, or over the
+			// debug console when the performance overlay is up
 			C2D_TargetClear(_bot, C2D_Color32(0x00, 0x00, 0x00, 0xff));
 			C2D_SceneBegin(_bot);
 		}
@@ -86,7 +92,7 @@ namespace SuperHaxagon {
 
 	Platform3DS::~Platform3DS() {
 		// Call d'tors before filesystem and audio shutdown.
-		for (auto& track : _sfx) track = nullptr;
+		_sfx.clear();
 		_bgm = nullptr;
 		C2D_Fini();
 		C3D_Fini();
@@ -128,29 +134,15 @@ namespace SuperHaxagon {
 		return std::make_unique<Font3DS>(getPath(partial, Location::ROM), size, _buff);
 	}
 
-	// Note: If there are no available channels the audio is silently discarded
 	void Platform3DS::playSFX(AudioLoader& audio) {
-		auto channel = 1;
-		for (auto& player : _sfx) {
-			if (!player || player->isDone()) {
-				player = audio.instantiate();
-				if (!player) return;
-				player->setChannel(channel);
-				player->setLoop(false);
-				player->play();
-				break;
-			}
-
-			channel++;
-		}
+		_sfx.play(audio);
 	}
 
-	void Platform3DS::playBGM(AudioLoader& audio) {
-		_bgm = audio.instantiate();
-		if (!_bgm) return;
-		_bgm->setChannel(0);
-		_bgm->setLoop(true);
-		_bgm->play();
+	std::unique_ptr<AudioPlayer> Platform3DS::swapBGM(std::unique_ptr<AudioPlayer> bgm) {
+		// The BGM owns channel 0, so the old one has to stop before the new one starts
+		_bgm = nullptr;
+		if (bgm) bgm->setChannel(0);
+		return Platform::swapBGM(std::move(bgm));
 	}
 
 	std::string Platform3DS::getButtonName(const Buttons& button) {
@@ -159,6 +151,7 @@ namespace SuperHaxagon {
 		if (button.left) return "LEFT";
 		if (button.right) return "RIGHT";
 		if (button.quit) return "START";
+		if (button.overlay) return "SELECT";
 		return "?";
 	}
 
@@ -169,6 +162,7 @@ namespace SuperHaxagon {
 		buttons.select = (input & KEY_A) > 0;
 		buttons.back = (input & KEY_B) > 0;
 		buttons.quit = (input & KEY_START) > 0;
+		buttons.overlay = (input & KEY_SELECT) > 0;
 		buttons.left = (input & (KEY_L | KEY_ZL | KEY_CSTICK_LEFT | KEY_CPAD_LEFT | KEY_DLEFT | KEY_Y)) > 0;
 		buttons.right = (input & (KEY_R | KEY_ZR | KEY_CSTICK_RIGHT | KEY_CPAD_RIGHT | KEY_DRIGHT | KEY_X)) > 0;
 		return buttons;
@@ -195,10 +189,12 @@ namespace SuperHaxagon {
 	}
 
 	void Platform3DS::screenFinalize() {
+		SUPER_HAXAGON_ZONE(_profiler, Zone::FINALIZE);
 		C3D_FrameEnd(0);
 	}
 
 	void Platform3DS::drawPoly(const Color& color, const std::vector<Point>& points) {
+		SUPER_HAXAGON_POLY(_profiler, points.size());
 		const auto c = C2D_Color32(color.r, color.g, color.b, color.a);
 		for (size_t i = 1; i < points.size() - 1; i++) {
 			C2D_DrawTriangle(
@@ -219,21 +215,14 @@ namespace SuperHaxagon {
 	}
 
 	void Platform3DS::shutdown() {
-		auto display = false;
-		for (const auto& message : _messages) {
-			if (message.first == Dbg::FATAL) {
-				display = true;
-			}
-		}
-
-		if (display) {
+		if (_messages.hasFatal()) {
 			if (_dbg == Dbg::FATAL) {
 				// Need to create console to show user the error
 				consoleInit(GFX_TOP, nullptr);
 				std::cout << "Fatal error! START to quit." << std::endl;
 				std::cout << "Last messages:" << std::endl << std::endl;
-				for (const auto& message : _messages) {
-					std::cout << message.second << std::endl;
+				for (size_t i = 0; i < _messages.size(); i++) {
+					std::cout << _messages.get(i) << std::endl;
 				}
 			} else {
 				// Otherwise the console exists and just needs to show
@@ -256,24 +245,21 @@ namespace SuperHaxagon {
 		}
 	}
 
-	void Platform3DS::message(const Dbg dbg, const std::string& where, const std::string& message) {
-		std::string format;
+	void Platform3DS::output(const Dbg dbg, const std::string& where, const std::string& message) {
+		const char* tag = "";
 		if (dbg == Dbg::INFO) {
-			format = "[3ds:info] ";
+			tag = "[3ds:info] ";
 		} else if (dbg == Dbg::WARN) {
-			format = "[3ds:warn] ";
+			tag = "[3ds:warn] ";
 		} else if (dbg == Dbg::FATAL) {
-			format = "[3ds:fatal] ";
+			tag = "[3ds:fatal] ";
 		}
 
-		format += where + ": " + message;
+		const auto* line = _messages.add(dbg, tag, where, message);
 
 		if (_dbg != Dbg::FATAL) {
 			// If we are in non FATAL mode, there's a console to print to
-			std::cout << format << std::endl;
+			std::cout << line << std::endl;
 		}
-
-		_messages.emplace_back(dbg, format);
-		if (_messages.size() > 32) _messages.pop_front();
 	}
 }
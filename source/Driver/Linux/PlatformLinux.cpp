@@ -24,7 +24,7 @@ namespace SuperHaxagon {
 		return "";
 	}
 
-	void PlatformLinux::message(const Dbg dbg, const std::string& where, const std::string& message) {
+	void PlatformLinux::output(const Dbg dbg, const std::string& where, const std::string& message) {
 		if (dbg == Dbg::INFO) {
 			std::cout << "[linux:info] " + where + ": " + message << std::endl;
 		} else if (dbg == Dbg::WARN) {
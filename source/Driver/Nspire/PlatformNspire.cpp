@@ -12,6 +12,10 @@
 
 namespace SuperHaxagon {
 	PlatformNspire::PlatformNspire(const Dbg dbg) : Platform(dbg) {
+		// Custom packs are the only thing that can grow, and the heap is shared with the OS
+		_memory.setBudget(MemoryTag::LEVELS, 512 * 1024);
+		_memory.setBudget(MemoryTag::PATTERNS, 1024 * 1024);
+
 		_gc = gui_gc_global_GC();
 		gui_gc_begin(_gc);
 		gui_gc_setColorRGB(_gc, 0, 0, 0);
@@ -70,19 +74,13 @@ namespace SuperHaxagon {
 		return std::make_unique<FontNspire>(_gc, size);
 	}
 
-	void PlatformNspire::playBGM(AudioLoader& audio) {
-		_bgm = audio.instantiate();
-		if (!_bgm) return;
-		_bgm->setLoop(true);
-		_bgm->play();
-	}
-
 	std::string PlatformNspire::getButtonName(const Buttons& button) {
 		if (button.back) return "ESC";
 		if (button.select) return "ENTER";
 		if (button.left) return "4";
 		if (button.right) return "6";
 		if (button.quit) return "MENU";
+		if (button.overlay) return "TAB";
 		return "?";
 	}
 
@@ -93,6 +91,7 @@ namespace SuperHaxagon {
 		buttons.quit = isKeyPressed(KEY_NSPIRE_HOME) > 0 || isKeyPressed(KEY_NSPIRE_MENU) > 0;
 		buttons.left = isKeyPressed(KEY_NSPIRE_4) > 0;
 		buttons.right = isKeyPressed(KEY_NSPIRE_6)  > 0;
+		buttons.overlay = isKeyPressed(KEY_NSPIRE_TAB) > 0;
 		return buttons;
 	}
 
@@ -107,10 +106,12 @@ namespace SuperHaxagon {
 	}
 
 	void PlatformNspire::screenFinalize() {
+		SUPER_HAXAGON_ZONE(_profiler, Zone::FINALIZE);
 		gui_gc_blit_to_screen(_gc);
 	}
 
 	void PlatformNspire::drawPoly(const Color& color, const std::vector<Point>& points) {
+		SUPER_HAXAGON_POLY(_profiler, points.size());
 		const auto pos = std::make_unique<Point2D[]>(points.size());
 		for (size_t i = 0; i < points.size(); i++) {
 			pos[i] = { points[i].x, points[i].y };
@@ -125,7 +126,7 @@ namespace SuperHaxagon {
 		timer_restore(0);
 	}
 
-	void PlatformNspire::message(const Dbg dbg, const std::string& where, const std::string& message) {
+	void PlatformNspire::output(const Dbg dbg, const std::string& where, const std::string& message) {
 		if (dbg == Dbg::INFO) {
 			std::cout << "[ndless:info] " + where + ": " + message << std::endl;
 		} else if (dbg == Dbg::WARN) {
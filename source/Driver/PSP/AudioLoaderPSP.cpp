@@ -1,14 +1,42 @@
 #include "Driver/PSP/AudioLoaderPSP.hpp"
 
-#include <istream>
+#include "Core/OggStream.hpp"
+#include "Core/Sound.hpp"
+
+#include <fstream>
 
 namespace SuperHaxagon {
-	AudioLoaderPSP::AudioLoaderPSP(const std::string& /* path */, Stream /* stream */) {
-		// TODO
+	AudioLoaderPSP::AudioLoaderPSP(Mixer& mixer, const std::string& path, const Stream stream) : _mixer(mixer) {
+		// BGMs are decoded as they play, one stream per player
+		if (stream != Stream::DIRECT) {
+			_streamPath = path + ".ogg";
+			return;
+		}
+
+		std::ifstream file(path + ".wav", std::ios::in | std::ios::binary);
+		if (file) _sound = loadWav(file);
+
+#ifdef SUPER_HAXAGON_ADPCM_SFX
+		// A quarter of the memory, decoded by the mixer as it plays
+		if (_sound && !_sound->isCompressed()) {
+			auto compressed = compressAdpcm(*_sound);
+			if (compressed) _sound = std::move(compressed);
+		}
+#endif
 	}
 
 	std::unique_ptr<AudioPlayer> AudioLoaderPSP::instantiate() {
-		// TODO
-		return std::make_unique<AudioPlayerPSP>();
+		if (!_streamPath.empty()) {
+			auto stream = std::make_shared<OggStream>(_streamPath);
+			if (!stream->isOpen()) return nullptr;
+			return std::make_unique<AudioPlayerPSP>(_mixer, std::move(stream));
+		}
+
+		if (!_sound) return nullptr;
+		return std::make_unique<AudioPlayerPSP>(_mixer, _sound);
+	}
+
+	size_t AudioLoaderPSP::getSize() const {
+		return _sound ? _sound->getBytes() : 0;
 	}
 }
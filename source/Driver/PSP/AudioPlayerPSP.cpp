@@ -1,25 +1,58 @@
 #include "Driver/PSP/AudioPlayerPSP.hpp"
 
+#include "Core/Mixer.hpp"
+#include "Core/OggStream.hpp"
+
 namespace SuperHaxagon {
-	AudioPlayerPSP::AudioPlayerPSP() {
-		// TODO
+	AudioPlayerPSP::AudioPlayerPSP(Mixer& mixer, std::shared_ptr<const Sound> sound) :
+		_mixer(mixer),
+		_sound(std::move(sound)) {}
+
+	AudioPlayerPSP::AudioPlayerPSP(Mixer& mixer, std::shared_ptr<OggStream> stream) :
+		_mixer(mixer),
+		_stream(std::move(stream)) {}
+
+	AudioPlayerPSP::~AudioPlayerPSP() {
+		if (_mixer.isPlaying(_voice)) _mixer.stop(_voice);
+	}
+
+	void AudioPlayerPSP::setLoop(const bool loop) {
+		_loop = loop;
+		if (_stream) _stream->setLoop(loop);
 	}
 
 	void AudioPlayerPSP::play() {
-		// TODO
+		// Resume if we were paused, otherwise start over on a new voice
+		if (_mixer.isPlaying(_voice)) {
+			if (_paused) {
+				_paused = false;
+				_mixer.setPaused(_voice, false);
+				return;
+			}
+
+			_mixer.stop(_voice);
+		}
+
+		_paused = false;
+		_voice = _stream ? _mixer.play(_stream, _volume) : _mixer.play(_sound, _loop, _volume);
 	}
 	
 	void AudioPlayerPSP::pause() {
-		// TODO
+		if (!_mixer.isPlaying(_voice)) return;
+		_paused = true;
+		_mixer.setPaused(_voice, true);
 	}
 
 	bool AudioPlayerPSP::isDone() const {
-		// TODO
-		return true;
+		return !_mixer.isPlaying(_voice);
 	}
 	
 	float AudioPlayerPSP::getTime() const {
-		// TODO
-		return 0.0f;
+		return _mixer.getTime(_voice);
+	}
+
+	void AudioPlayerPSP::setVolume(const float volume) {
+		_volume = volume;
+		if (_mixer.isPlaying(_voice)) _mixer.setGain(_voice, volume);
 	}
 }
@@ -1,5 +1,6 @@
 #include "Driver/PSP/PlatformPSP.hpp"
 
+#include "Core/Mixer.hpp"
 #include "Core/Twist.hpp"
 #include "Driver/PSP/AudioLoaderPSP.hpp"
 #include "Driver/PSP/AudioPlayerPSP.hpp"
@@ -8,6 +9,7 @@
 
 #include <assert.h>
 #include <filesystem>
+#include <pspaudiolib.h>
 #include <pspctrl.h>
 #include <pspdebug.h>
 #include <pspdisplay.h>
@@ -43,12 +45,31 @@ namespace SuperHaxagon {
 		_rom_dir(_game_dir + "/romfs"),
 		_user_dir(_game_dir + "/sdmc")
 	{
+		_logger.setLevel(dbg);
 		std::filesystem::create_directories(_user_dir);
+
+		// Enough latency to ride out a slow frame, since we only pump once per frame
+		_mixer = std::make_unique<Mixer>(44100, 4096);
+#ifdef SUPER_HAXAGON_PROFILE
+		_mixer->setTrace(&_profiler.getTrace());
+#endif
 		_running = initCallbacks() && initVideo() && initAudio() &&
 			initController();
 	}
 
+	PlatformPSP::~PlatformPSP() {
+		// The callback and the BGM must be gone before the mixer they use
+		pspAudioEnd();
+		_sfx.clear();
+		_bgm = nullptr;
+	}
+
 	bool PlatformPSP::loop() {
+		// There are no threads of our own, so top the mixer up every frame
+		if (_mixer) {
+			_mixer->pump();
+			_mixer->collect();
+		}
 		return _running;
 	}
 
@@ -70,19 +91,24 @@ namespace SuperHaxagon {
 	}
 
 	std::unique_ptr<AudioLoader> PlatformPSP::loadAudio(const std::string& partial, const Stream stream, const Location location) {
-		return std::make_unique<AudioLoaderPSP>(getPath(partial, location), stream);
+		return std::make_unique<AudioLoaderPSP>(*_mixer, getPath(partial, location), stream);
 	}
 
 	std::unique_ptr<Font> PlatformPSP::loadFont(const std::string& partial, int size) {
 		return std::make_unique<FontPSP>(getPath(partial, Location::ROM), size);
 	}
 
-	void PlatformPSP::playSFX(AudioLoader& /* audio */) {
-		// TODO: Play SFX.
+	void PlatformPSP::playSFX(AudioLoader& audio) {
+		_sfx.play(audio);
 	}
 
-	void PlatformPSP::playBGM(AudioLoader& /* audio */) {
-		// TODO: Play BGM.
+	float PlatformPSP::getAudioFill() const {
+		if (!_mixer) return -1.0f;
+		return static_cast<float>(_mixer->getQueued()) / static_cast<float>(_mixer->getCapacity());
+	}
+
+	uint32_t PlatformPSP::getAudioUnderruns() const {
+		return _mixer ? _mixer->getUnderruns() : 0;
 	}
 
 	std::string PlatformPSP::getButtonName(const Buttons& button) {
@@ -92,6 +118,7 @@ namespace SuperHaxagon {
 		if (button.back) return "O";
 		if (button.left) return "L";
 		if (button.right) return "R";
+		if (button.overlay) return "SELECT";
 		return "?";
 	}
 
@@ -100,13 +127,14 @@ namespace SuperHaxagon {
 		// quit using the PlayStation button.
 		SceCtrlData pad;
 		sceCtrlPeekBufferPositive(&pad, 1);
-		Buttons buttons;
+		Buttons buttons{};
 		buttons.select = static_cast<bool>(pad.Buttons & PSP_CTRL_CROSS);
 		buttons.back = static_cast<bool>(pad.Buttons & PSP_CTRL_CIRCLE);
 		buttons.left = static_cast<bool>(pad.Buttons & PSP_CTRL_LTRIGGER)
 			|| static_cast<bool>(pad.Buttons & PSP_CTRL_LEFT);
 		buttons.right = static_cast<bool>(pad.Buttons & PSP_CTRL_RTRIGGER)
 			|| static_cast<bool>(pad.Buttons & PSP_CTRL_RIGHT);
+		buttons.overlay = static_cast<bool>(pad.Buttons & PSP_CTRL_SELECT);
 		return buttons;
 	}
 
@@ -136,13 +164,19 @@ namespace SuperHaxagon {
 			pspDebugScreenPrintf("%.3f%%", frame_ms / budget_ms * 100.0f);
 		}
 
-		sceGuFinish();
-		sceGuSync(GU_SYNC_FINISH, GU_SYNC_WHAT_DONE);
+		{
+			// Waiting for vblank is not work, so it stays out of the zone
+			SUPER_HAXAGON_ZONE(_profiler, Zone::FINALIZE);
+			sceGuFinish();
+			sceGuSync(GU_SYNC_FINISH, GU_SYNC_WHAT_DONE);
+		}
+
 		sceDisplayWaitVblankStart();
 		_draw_buf = sceGuSwapBuffers();
 	}
 
 	void PlatformPSP::drawPoly(const Color& color, const std::vector<Point>& points) {
+		SUPER_HAXAGON_POLY(_profiler, points.size());
 		struct Vertex {
 			float x;
 			float y;
@@ -178,10 +212,7 @@ namespace SuperHaxagon {
 		sceKernelExitGame();
 	}
 
-	void PlatformPSP::message(const Dbg dbg, const std::string& where, const std::string& message) {
-		if (dbg < _dbg) {
-			return;
-		}
+	void PlatformPSP::output(const Dbg dbg, const std::string& where, const std::string& message) {
 		std::string format;
 		switch (dbg) {
 		case Dbg::WARN:
@@ -281,10 +312,15 @@ namespace SuperHaxagon {
 	}
 
 	bool PlatformPSP::initAudio() {
-		// TODO: Initialize audio.
+		if (pspAudioInit() < 0) return false;
+		pspAudioSetChannelCallback(0, audioCallback, this);
 		return true;
 	}
 
+	void PlatformPSP::audioCallback(void* buffer, const unsigned int frames, void* data) {
+		static_cast<PlatformPSP*>(data)->_mixer->pull(static_cast<int16_t*>(buffer), frames);
+	}
+
 	bool PlatformPSP::initController() {
 		sceCtrlSetSamplingCycle(0);
 		/* The analog stick isn't used. */
@@ -11,8 +11,9 @@ namespace SuperHaxagon {
 				_stream = Stream::DIRECT;
 			}
 		} else if (stream == Stream::INDIRECT) {
+			_path = path + ".ogg";
 			_music = std::make_unique<sf::Music>();
-			if (_music->openFromFile(path + ".ogg")) {
+			if (_music->openFromFile(_path)) {
 				_stream = Stream::INDIRECT;
 			}
 		}
@@ -28,10 +29,26 @@ namespace SuperHaxagon {
 		}
 
 		if (_stream == Stream::INDIRECT) {
-			_stream = Stream::NONE;
+			// The music opened up front goes to the first player, later ones open their own
+			if (!_music) {
+				_music = std::make_unique<sf::Music>();
+				if (!_music->openFromFile(_path)) {
+					_music = nullptr;
+					return nullptr;
+				}
+			}
+
 			return std::make_unique<AudioPlayerMusicSFML>(std::move(_music));
 		}
 
 		return nullptr;
 	}
+
+	size_t AudioLoaderSFML::getSize() const {
+		if (_buffer) return _buffer->getSampleCount() * sizeof(sf::Int16);
+
+		// sf::Music keeps a second of audio around to stream from
+		if (_music) return _music->getSampleRate() * _music->getChannelCount() * sizeof(sf::Int16);
+		return 0;
+	}
 }
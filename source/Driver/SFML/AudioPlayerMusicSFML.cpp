@@ -23,7 +23,20 @@ namespace SuperHaxagon {
 		return _music->getStatus() == sf::SoundSource::Stopped;
 	}
 
+	void AudioPlayerMusicSFML::setVolume(const float volume) {
+		_music->setVolume(volume * 100.0f);
+	}
+
 	float AudioPlayerMusicSFML::getTime() const {
-		return _music->getPlayingOffset().asSeconds();
+		// Republishing an offset that has not moved would hold the clock still
+		const auto offset = _music->getPlayingOffset();
+		const auto running = _music->getStatus() == sf::SoundSource::Playing;
+		if (offset.asMicroseconds() != _offset || running != _running) {
+			_offset = offset.asMicroseconds();
+			_running = running;
+			_clock.publish(offset.asSeconds(), running);
+		}
+
+		return _clock.getTime();
 	}
 }
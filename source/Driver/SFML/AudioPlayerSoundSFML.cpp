@@ -20,6 +20,6 @@ namespace SuperHaxagon {
 	}
 
 	float AudioPlayerSoundSFML::getTime() const {
-		return 0;
+		return _sound->getPlayingOffset().asSeconds();
 	}
 }
@@ -0,0 +1,131 @@
+#include "Driver/SFML/InputSamplerSFML.hpp"
+
+#include <SFML/Window/Keyboard.hpp>
+#include <SFML/System/Sleep.hpp>
+
+#include <algorithm>
+
+namespace SuperHaxagon {
+	// A millisecond is as fine as sleeping gets on every desktop
+	static const sf::Time POLL = sf::milliseconds(1);
+
+	static float fraction(const InputSamplerSFML::Clock::duration held, const float length) {
+		return std::min(std::chrono::duration<float>(held).count() / length, 1.0f);
+	}
+
+	static Buttons poll() {
+		Buttons buttons{};
+		buttons.select = sf::Keyboard::isKeyPressed(sf::Keyboard::Enter);
+		buttons.back = sf::Keyboard::isKeyPressed(sf::Keyboard::Escape);
+		buttons.quit = sf::Keyboard::isKeyPressed(sf::Keyboard::Delete);
+		buttons.overlay = sf::Keyboard::isKeyPressed(sf::Keyboard::F3);
+		buttons.left = sf::Keyboard::isKeyPressed(sf::Keyboard::Left) | sf::Keyboard::isKeyPressed(sf::Keyboard::A);
+		buttons.right = sf::Keyboard::isKeyPressed(sf::Keyboard::Right) | sf::Keyboard::isKeyPressed(sf::Keyboard::D);
+		return buttons;
+	}
+
+	InputSamplerSFML::~InputSamplerSFML() {
+		stop();
+	}
+
+	void InputSamplerSFML::start() {
+		if (isRunning()) return;
+
+		_left = {};
+		_right = {};
+		_pressed = {};
+		_taken = Clock::now();
+		_running = true;
+		_thread = std::thread(&InputSamplerSFML::run, this);
+	}
+
+	void InputSamplerSFML::stop() {
+		if (!isRunning()) return;
+
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_running = false;
+		}
+
+		_wake.notify_one();
+		_thread.join();
+	}
+
+	void InputSamplerSFML::setFocus(const bool focus) {
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_focus = focus;
+		}
+
+		_wake.notify_one();
+	}
+
+	Buttons InputSamplerSFML::getPressed() {
+		// Stopped, so nothing else is asking the keyboard
+		if (!isRunning()) return _focus ? poll() : Buttons{};
+
+		std::lock_guard<std::mutex> lock(_mutex);
+		return _pressed;
+	}
+
+	Held InputSamplerSFML::take() {
+		std::lock_guard<std::mutex> lock(_mutex);
+		const auto now = Clock::now();
+		const auto length = std::chrono::duration<float>(now - _taken).count();
+		_taken = now;
+
+		const auto left = collect(_left, now);
+		const auto right = collect(_right, now);
+		if (length <= 0) return {0, 0};
+		return {fraction(left, length), fraction(right, length)};
+	}
+
+	void InputSamplerSFML::run() {
+		while (_running.load(std::memory_order_relaxed)) {
+			if (!_focus.load(std::memory_order_relaxed)) {
+				// Let go of everything, then sleep until there is something to watch
+				std::unique_lock<std::mutex> lock(_mutex);
+				const auto now = Clock::now();
+				_pressed = {};
+				sample(_left, false, now);
+				sample(_right, false, now);
+				_wake.wait(lock, [this] {return !_running || _focus;});
+				continue;
+			}
+
+			const auto pressed = poll();
+
+			// Left wins while both are down, the same as it always has
+			const auto left = static_cast<bool>(pressed.left);
+			const auto right = !left && pressed.right;
+
+			{
+				std::lock_guard<std::mutex> lock(_mutex);
+				const auto now = Clock::now();
+				_pressed = pressed;
+				sample(_left, left, now);
+				sample(_right, right, now);
+			}
+
+			sf::sleep(POLL);
+		}
+	}
+
+	void InputSamplerSFML::sample(Key& key, const bool down, const Clock::time_point now) {
+		if (down == key.down) return;
+		if (down) key.since = now;
+		else key.held += now - key.since;
+		key.down = down;
+	}
+
+	InputSamplerSFML::Clock::duration InputSamplerSFML::collect(Key& key, const Clock::time_point now) {
+		auto held = key.held;
+		if (key.down) {
+			held += now - key.since;
+			key.since = now;
+		}
+
+		key.held = {};
+		return held;
+	}
+}
@@ -0,0 +1,80 @@
+#include "Driver/SFML/MetricsServerSFML.hpp"
+
+#include "Core/Metrics.hpp"
+
+#include <SFML/Network/SocketSelector.hpp>
+#include <SFML/Network/TcpSocket.hpp>
+
+#include <sstream>
+#include <string>
+
+namespace SuperHaxagon {
+	// How long before the thread checks if it should stop, or gives up on a slow client
+	static const sf::Time POLL = sf::milliseconds(250);
+	static const sf::Time TIMEOUT = sf::seconds(1);
+
+	// Only the request line matters, so the headers are read and thrown away
+	static std::string readRequest(sf::TcpSocket& client) {
+		sf::SocketSelector selector;
+		selector.add(client);
+
+		std::string request;
+		char buffer[512];
+		while (request.find("\r\n\r\n") == std::string::npos && request.size() < 4096) {
+			if (!selector.wait(TIMEOUT)) break;
+			std::size_t received = 0;
+			if (client.receive(buffer, sizeof(buffer), received) != sf::Socket::Done) break;
+			request.append(buffer, received);
+		}
+
+		return request;
+	}
+
+	static void respond(sf::TcpSocket& client, const char* status, const std::string& body) {
+		std::stringstream response;
+		response << "HTTP/1.0 " << status << "\r\n"
+			<< "Content-Type: text/plain; version=0.0.4\r\n"
+			<< "Content-Length: " << body.size() << "\r\n"
+			<< "Connection: close\r\n\r\n"
+			<< body;
+
+		const auto text = response.str();
+		client.send(text.data(), text.size());
+	}
+
+	MetricsServerSFML::MetricsServerSFML(Metrics& metrics) : _metrics(metrics) {}
+
+	MetricsServerSFML::~MetricsServerSFML() {
+		_running = false;
+		if (_thread.joinable()) _thread.join();
+	}
+
+	bool MetricsServerSFML::listen(const unsigned short port) {
+		// Nothing from outside the machine, the fleet collects through its own agent
+		if (_listener.listen(port, sf::IpAddress::LocalHost) != sf::Socket::Done) return false;
+		_running = true;
+		_thread = std::thread(&MetricsServerSFML::run, this);
+		return true;
+	}
+
+	void MetricsServerSFML::run() {
+		sf::SocketSelector selector;
+		selector.add(_listener);
+		while (_running) {
+			if (!selector.wait(POLL)) continue;
+
+			sf::TcpSocket client;
+			if (_listener.accept(client) != sf::Socket::Done) continue;
+
+			const auto request = readRequest(client);
+			if (request.rfind("GET /metrics ", 0) != 0) {
+				respond(client, "404 Not Found", "not found\n");
+				continue;
+			}
+
+			std::stringstream body;
+			_metrics.write(body);
+			respond(client, "200 OK", body.str());
+		}
+	}
+}
@@ -3,36 +3,59 @@
 #include "Core/Structs.hpp"
 #include "Driver/SFML/AudioLoaderSFML.hpp"
 #include "Driver/SFML/FontSFML.hpp"
-#include "Driver/SFML/AudioPlayerSoundSFML.hpp"
 
 #include <array>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <string>
+#include <thread>
 
 namespace SuperHaxagon {
 	PlatformSFML::PlatformSFML(const Dbg dbg, sf::VideoMode video) : Platform(dbg) {
 		_clock.restart();
 
-		sf::ContextSettings settings;
-		settings.antialiasingLevel = 8;
+		_window = std::make_unique<sf::RenderWindow>();
+		createWindow(video);
 
-		_window = std::make_unique<sf::RenderWindow>(video, "Super Haxagon", sf::Style::Default, settings);
-		_window->setVerticalSyncEnabled(true);
+		const auto* pacing = std::getenv(PACING_ENV);
+		_pacing = !pacing || std::strcmp(pacing, "0") != 0;
+		_input = std::make_unique<InputSamplerSFML>();
 		_loaded = true;
 	}
 
 	PlatformSFML::~PlatformSFML() = default;
 
 	bool PlatformSFML::loop() {
-		const auto throttle = sf::milliseconds(1);
-		sf::sleep(throttle);
+		// The constructor is too early, as the platform cannot report anything yet
+		if (!_metricsChecked) startMetrics();
+
+		// Start as late as the frame can afford, so input is read just
+		// before it is needed instead of a whole frame early
+		if (_pacing && _pacer.getState() == FramePacer::State::PACING) {
+			waitUntil(_pacer.getWake());
+		} else {
+			const auto throttle = sf::milliseconds(1);
+			sf::sleep(throttle);
+		}
+
 		_delta = _clock.getElapsedTime().asSeconds();
 		_clock.restart();
+		_pacer.begin(FramePacer::Clock::now());
 		sf::Event event{};
 		while (_window->pollEvent(event)) {
 			if (event.type == sf::Event::Closed) _window->close();
-			if (event.type == sf::Event::GainedFocus) _focus = true;
-			if (event.type == sf::Event::LostFocus) _focus = false;
+			if (event.type == sf::Event::LostFocus) _input->setFocus(false);
+
+			if (event.type == sf::Event::GainedFocus) {
+				// The window could have moved to another display
+				_input->setFocus(true);
+				_pacer.reset();
+			}
+
 			if (event.type == sf::Event::Resized) {
+				_pacer.reset();
+
 				const auto width = event.size.width > 400 ? event.size.width : 400;
 				const auto height = event.size.height > 240 ? event.size.height : 240;
 
@@ -53,6 +76,41 @@ namespace SuperHaxagon {
 		return _loaded && _window->isOpen();
 	}
 
+	void PlatformSFML::startMetrics() {
+		_metricsChecked = true;
+		const auto* env = std::getenv(METRICS_PORT_ENV);
+		if (!env) return;
+
+		const auto port = std::atoi(env);
+		if (port <= 0 || port > 65535) {
+			message(Dbg::WARN, "metrics", std::string("invalid port ") + env);
+			return;
+		}
+
+		_metricsServer = std::make_unique<MetricsServerSFML>(_metrics);
+		if (!_metricsServer->listen(static_cast<unsigned short>(port))) {
+			message(Dbg::WARN, "metrics", "could not listen on port " + std::to_string(port));
+			_metricsServer = nullptr;
+			return;
+		}
+
+		if (isLogged(Dbg::INFO)) message(Dbg::INFO, "metrics", "serving on http://localhost:" + std::to_string(port) + "/metrics");
+	}
+
+	void PlatformSFML::waitUntil(const FramePacer::Clock::time_point wake) {
+		const auto sleep = std::chrono::duration<float>(wake - FramePacer::Clock::now()).count() - SPIN_SECONDS;
+		if (sleep > 0) sf::sleep(sf::seconds(sleep));
+		while (FramePacer::Clock::now() < wake) std::this_thread::yield();
+	}
+
+	void PlatformSFML::createWindow(const sf::VideoMode video) {
+		sf::ContextSettings settings;
+		settings.antialiasingLevel = _samples;
+
+		_window->create(video, "Super Haxagon", sf::Style::Default, settings);
+		_window->setVerticalSyncEnabled(true);
+	}
+
 	float PlatformSFML::getDilation() {
 		// The game was originally designed with 60FPS in mind
 		const auto dilation = _delta / (1.0f / 60.0f);
@@ -68,27 +126,7 @@ namespace SuperHaxagon {
 	}
 
 	void PlatformSFML::playSFX(AudioLoader& audio) {
-		for (auto it = _sfx.begin(); it != _sfx.end();) {
-			auto& playing = *it;
-			if (playing->isDone()) {
-				it = _sfx.erase(it);
-			} else {
-				++it;
-			}
-		}
-
-		auto player = audio.instantiate();
-		if (!player) return;
-		player->setLoop(false);
-		player->play();
-		_sfx.emplace_back(std::move(player));
-	}
-
-	void PlatformSFML::playBGM(AudioLoader& audio) {
-		_bgm = audio.instantiate();
-		if (!_bgm) return;
-		_bgm->setLoop(true);
-		_bgm->play();
+		_sfx.play(audio);
 	}
 
 	std::string PlatformSFML::getButtonName(const Buttons& button) {
@@ -97,18 +135,22 @@ namespace SuperHaxagon {
 		if (button.left) return "LEFT";
 		if (button.right) return "RIGHT";
 		if (button.quit) return "DELETE";
+		if (button.overlay) return "F3";
 		return "?";
 	}
 
 	Buttons PlatformSFML::getPressed() {
-		Buttons buttons{};
-		if (!_focus) return buttons;
-		buttons.select = sf::Keyboard::isKeyPressed(sf::Keyboard::Enter);
-		buttons.back = sf::Keyboard::isKeyPressed(sf::Keyboard::Escape);
-		buttons.quit = sf::Keyboard::isKeyPressed(sf::Keyboard::Delete);
-		buttons.left = sf::Keyboard::isKeyPressed(sf::Keyboard::Left) | sf::Keyboard::isKeyPressed(sf::Keyboard::A);
-		buttons.right = sf::Keyboard::isKeyPressed(sf::Keyboard::Right) | sf::Keyboard::isKeyPressed(sf::Keyboard::D);
-		return buttons;
+		return _input->getPressed();
+	}
+
+	Held PlatformSFML::getHeld() {
+		if (!_input->isRunning()) return Platform::getHeld();
+		return _input->take();
+	}
+
+	void PlatformSFML::setSampling(const bool sampling) {
+		if (sampling) _input->start();
+		else _input->stop();
 	}
 
 	Point PlatformSFML::getScreenDim() const {
@@ -123,10 +165,34 @@ namespace SuperHaxagon {
 	}
 
 	void PlatformSFML::screenFinalize() {
+		// Includes waiting for vsync
+		SUPER_HAXAGON_ZONE(_profiler, Zone::FINALIZE);
+		const auto before = FramePacer::Clock::now();
 		_window->display();
+
+		// Measured even with pacing off, so the two can be compared
+		const auto changed = _pacer.presented(before, FramePacer::Clock::now());
+		_metrics.getInputLatency().observe(_pacer.getLatency());
+		if (!changed || !_pacing || !isLogged(Dbg::INFO)) return;
+
+		switch (_pacer.getState()) {
+		case FramePacer::State::PACING: {
+			char line[64];
+			std::snprintf(line, sizeof(line), "frames paced to %.1f Hz", 1.0f / _pacer.getPeriod());
+			message(Dbg::INFO, "pacing", line);
+			break;
+		}
+		case FramePacer::State::OFF:
+			message(Dbg::INFO, "pacing", "vsync is not limiting frames, leaving them unpaced");
+			break;
+		case FramePacer::State::CALIBRATING:
+			message(Dbg::INFO, "pacing", "presents stopped lining up, measuring the display again");
+			break;
+		}
 	}
 
 	void PlatformSFML::drawPoly(const Color& color, const std::vector<Point>& points) {
+		SUPER_HAXAGON_POLY(_profiler, points.size());
 		const sf::Color sfColor{ color.r, color.g, color.b, color.a };
 		sf::ConvexShape convex(points.size());
 		convex.setPosition(0, 0);
@@ -138,4 +204,22 @@ namespace SuperHaxagon {
 
 		_window->draw(convex);
 	}
+
+	unsigned PlatformSFML::getMaxSamples() const {
+		return SAMPLES;
+	}
+
+	void PlatformSFML::setSamples(const unsigned samples) {
+		if (samples == _samples) return;
+		_samples = samples;
+
+		// Antialiasing is fixed when the window is made, so it is made
+		// again in the same place at the same size
+		const auto size = _window->getSize();
+		const auto position = _window->getPosition();
+		createWindow(sf::VideoMode(size.x, size.y));
+		_window->setPosition(position);
+		_window->setView(sf::View(sf::FloatRect(0.0f, 0.0f, static_cast<float>(size.x), static_cast<float>(size.y))));
+		_pacer.reset();
+	}
 }
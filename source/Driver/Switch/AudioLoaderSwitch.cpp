@@ -25,4 +25,9 @@ namespace SuperHaxagon {
 		if (_music) return std::make_unique<AudioPlayerMusSwitch>(_music);
 		return nullptr;
 	}
+
+	size_t AudioLoaderSwitch::getSize() const {
+		// Music streams from the file, so only effects are held in memory
+		return _sfx ? _sfx->alen : 0;
+	}
 }
@@ -1,11 +1,18 @@
 #include "Driver/Switch/AudioPlayerMusSwitch.hpp"
 
-#include <switch/arm/counter.h>
-
 namespace SuperHaxagon {
-	AudioPlayerMusSwitch::AudioPlayerMusSwitch(Mix_Music* music) : _music(music) {}
+	AudioPlayerMusSwitch::AudioPlayerMusSwitch(Mix_Music* music) : _music(music) {
+		auto rate = 0;
+		auto channels = 0;
+		Uint16 format = 0;
+		if (Mix_QuerySpec(&rate, &format, &channels)) {
+			_rate = rate;
+			_frameBytes = channels * SDL_AUDIO_BITSIZE(format) / 8;
+		}
+	}
 
 	AudioPlayerMusSwitch::~AudioPlayerMusSwitch() {
+		Mix_SetPostMix(nullptr, nullptr);
 		Mix_HaltMusic();
 	}
 
@@ -19,19 +26,18 @@ namespace SuperHaxagon {
 			// This is because we need to detect when the music is over in order to reset the timers.
 			// The Switch platform specifically continuously calls play, so if we are not
 			// playing anything restart the music.
-			_start = getNow();
+			_restart.store(true, std::memory_order_release);
+			_clock.restart();
+			Mix_SetPostMix(postMix, this);
 			Mix_PlayMusic(_music, 1);
 			return;
 		}
 
 		// We are not done, so resume the currently playing music.
-		if (_diff > 0) _start += getNow() - _diff;
-		_diff = 0;
 		Mix_ResumeMusic();
 	}
 
 	void AudioPlayerMusSwitch::pause() {
-		_diff = getNow();
 		Mix_PauseMusic();
 	}
 
@@ -41,17 +47,18 @@ namespace SuperHaxagon {
 	}
 
 	float AudioPlayerMusSwitch::getTime() const {
-		// If we set diff (paused), we are frozen in time. Otherwise, the current timestamp is
-		// the system minus the start of the song.
-		return _diff > 0 ? _diff - _start : getNow() - _start;
-	}
-
-	float AudioPlayerMusSwitch::getNow() const {
-		// Note that this is kind of a shitty way to do this: if the user presses the
-		// home button while the game is running (and not at a game over screen) the
-		// clock will get offset from the music. I personally am not going to fix this,
-		// but if someone ever stumbles across this comment feel free to do something
-		// about it.
-		return armTicksToNs(armGetSystemTick()) / 1.0e9;
+		return _clock.getTime();
+	}
+
+	void AudioPlayerMusSwitch::postMix(void* data, Uint8*, const int length) {
+		// Runs on the audio thread with every buffer mixed for the device
+		auto& self = *static_cast<AudioPlayerMusSwitch*>(data);
+		if (!self._rate || !self._frameBytes) return;
+		if (self._restart.exchange(false, std::memory_order_acquire)) self._played = 0;
+
+		// The buffer starts playing as soon as the device takes it
+		const auto running = Mix_PlayingMusic() && !Mix_PausedMusic();
+		self._clock.publish(static_cast<float>(self._played) / static_cast<float>(self._rate), running);
+		if (running) self._played += static_cast<uint32_t>(length / self._frameBytes);
 	}
 }
@@ -3,9 +3,17 @@
 namespace SuperHaxagon {
 	AudioPlayerSfxSwitch::AudioPlayerSfxSwitch(Mix_Chunk* sfx) : _sfx(sfx) {}
 	
-	AudioPlayerSfxSwitch::~AudioPlayerSfxSwitch() = default;
+	AudioPlayerSfxSwitch::~AudioPlayerSfxSwitch() {
+		if (_channel >= 0 && Mix_GetChunk(_channel) == _sfx) Mix_HaltChannel(_channel);
+	}
 
 	void AudioPlayerSfxSwitch::play() {
-		Mix_PlayChannel(-1, _sfx, 0);
+		// Playing on a busy channel cuts off whatever was there
+		Mix_PlayChannel(_channel, _sfx, 0);
+	}
+
+	bool AudioPlayerSfxSwitch::isDone() const {
+		// Without a channel of its own there is nothing to wait on
+		return _channel < 0 || !Mix_Playing(_channel);
 	}
 }
@@ -91,7 +91,7 @@ namespace SuperHaxagon {
 		SDL_Init(SDL_INIT_AUDIO);
 		Mix_Init(MIX_INIT_OGG);
 		Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT, MIX_DEFAULT_CHANNELS, 4096);
-		Mix_AllocateChannels(16);
+		Mix_AllocateChannels(SFX_VOICES);
 
 		mkdir("sdmc:/switch", 0777);
 		mkdir("sdmc:/switch/SuperHaxagon", 0777);
@@ -140,6 +140,8 @@ namespace SuperHaxagon {
 	}
 
 	PlatformSwitch::~PlatformSwitch() {
+		_sfx.clear();
+		_bgm = nullptr;
 		Mix_Quit();
 		SDL_Quit();
 		romfsExit();
@@ -149,6 +151,10 @@ namespace SuperHaxagon {
 	bool PlatformSwitch::loop() {
 		if (!_loaded) return false;
 
+		// Polled once a frame, so the game can ask for buttons more than once
+		// without losing presses to the buttons that were just pressed
+		padUpdate(&_pad);
+
 		// Check up on the audio status
 		if (_bgm && _bgm->isDone()) _bgm->play();
 
@@ -179,16 +185,13 @@ namespace SuperHaxagon {
 	}
 
 	void PlatformSwitch::playSFX(AudioLoader& audio) {
-		auto sfx = audio.instantiate();
-		if (!sfx) return;
-		sfx->play();
+		_sfx.play(audio);
 	}
 
-	void PlatformSwitch::playBGM(AudioLoader& audio) {
-		_bgm = audio.instantiate();
-		if (!_bgm) return;
-		_bgm->setLoop(true);
-		_bgm->play();
+	std::unique_ptr<AudioPlayer> PlatformSwitch::swapBGM(std::unique_ptr<AudioPlayer> bgm) {
+		// SDL_mixer only has the one music stream, so there is nothing to fade
+		_bgm = nullptr;
+		return Platform::swapBGM(std::move(bgm));
 	}
 
 	std::string PlatformSwitch::getPath(const std::string& partial, const Location location) {
@@ -216,17 +219,18 @@ namespace SuperHaxagon {
 		if (button.left) return "LEFT";
 		if (button.right) return "RIGHT";
 		if (button.quit) return "PLUS";
+		if (button.overlay) return "MINUS";
 		return "?";
 	}
 
 	Buttons PlatformSwitch::getPressed() {
-		padUpdate(&_pad);
 		const auto kDown = padGetButtonsDown(&_pad);
 		const auto kPressed = padGetButtons(&_pad);
 		Buttons buttons{};
 		buttons.select = kDown & HidNpadButton_A;
 		buttons.back = kDown & HidNpadButton_B;
 		buttons.quit = kDown & HidNpadButton_Plus;
+		buttons.overlay = kPressed & HidNpadButton_Minus;
 		buttons.left = kPressed & (HidNpadButton_L | HidNpadButton_ZL | HidNpadButton_AnyLeft);
 		buttons.right = kPressed & (HidNpadButton_R | HidNpadButton_ZR | HidNpadButton_AnyRight);
 		return buttons;
@@ -244,6 +248,8 @@ namespace SuperHaxagon {
 	}
 
 	void PlatformSwitch::screenFinalize() {
+		SUPER_HAXAGON_ZONE(_profiler, Zone::FINALIZE);
+
 		// Want to render opaque first, then transparent
 		render(_targetVertex, false);
 		render(_targetVertexUV, false);
@@ -255,6 +261,7 @@ namespace SuperHaxagon {
 	}
 
 	void PlatformSwitch::drawPoly(const Color& color, const std::vector<Point>& points) {
+		SUPER_HAXAGON_POLY(_profiler, points.size());
 		const auto z = getAndIncrementZ();
 		auto& buffer = color.a == 0xFF || color.a == 0 ? _opaque : _transparent;
 		for (const auto& point : points) {
@@ -293,20 +300,13 @@ namespace SuperHaxagon {
 			eglTerminate(_display);
 		}
 
-		auto display = false;
-		for (const auto& message : _messages) {
-			if (message.first == Dbg::FATAL) {
-				display = true;
-			}
-		}
-
-		if (display) {
+		if (_messages.hasFatal()) {
 			// Need to create console to show user the error
 			consoleInit(nullptr);
 			std::cout << "Fatal error! START to quit." << std::endl;
 			std::cout << "Last messages:" << std::endl << std::endl;
-			for (const auto& message : _messages) {
-				std::cout << message.second << std::endl;
+			for (size_t i = 0; i < _messages.size(); i++) {
+				std::cout << _messages.get(i) << std::endl;
 			}
 
 			while (appletMainLoop()) {
@@ -318,27 +318,24 @@ namespace SuperHaxagon {
 		}
 	}
 
-	void PlatformSwitch::message(const Dbg dbg, const std::string& where, const std::string& message) {
-		std::string format;
+	void PlatformSwitch::output(const Dbg dbg, const std::string& where, const std::string& message) {
+		const char* tag = "";
 		if (dbg == Dbg::INFO) {
-			format = "[switch:info] ";
+			tag = "[switch:info] ";
 		}
 		else if (dbg == Dbg::WARN) {
-			format = "[switch:warn] ";
+			tag = "[switch:warn] ";
 		}
 		else if (dbg == Dbg::FATAL) {
-			format = "[switch:fatal] ";
+			tag = "[switch:fatal] ";
 		}
 
-		format += where + ": " + message;
+		const auto* line = _messages.add(dbg, tag, where, message);
 
 		if (_dbg != Dbg::FATAL) {
 			// If we are in non FATAL mode, write to a file
-			_console << format << std::endl;
+			_console << line << std::endl;
 		}
-
-		_messages.emplace_back(dbg, format);
-		if (_messages.size() > 32) _messages.pop_front();
 	}
 
 	bool PlatformSwitch::initEGL() {
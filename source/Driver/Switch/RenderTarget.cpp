@@ -172,7 +172,7 @@ namespace SuperHaxagon {
 		if (size < vector.size() || size == 0) {
 			if (size == 0) size = BUFFER_RESIZE_STEP;
 			while (size < vector.size()) size *= 2;
-			platform.message(Dbg::INFO, "platform", "resized " + label + " to " + std::to_string(size));
+			if (platform.isLogged(Dbg::INFO)) platform.message(Dbg::INFO, "platform", "resized " + label + " to " + std::to_string(size));
 			glBufferData(type, size * sizeof(T), vector.data(), GL_DYNAMIC_DRAW);
 		} else {
 			glBufferSubData(type, 0, size * sizeof(T), vector.data());
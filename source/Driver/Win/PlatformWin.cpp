@@ -28,7 +28,7 @@ namespace SuperHaxagon {
 		return "";
 	}
 
-	void PlatformWin::message(const Dbg dbg, const std::string& where, const std::string& message) {
+	void PlatformWin::output(const Dbg dbg, const std::string& where, const std::string& message) {
 		if (dbg == Dbg::INFO) {
 			std::cout << "[win:info] " + where + ": " + message << std::endl;
 		} else if (dbg == Dbg::WARN) {
@@ -24,7 +24,7 @@ namespace SuperHaxagon {
 		return "";
 	}
 
-	void PlatformMacOS::message(const Dbg dbg, const std::string& where, const std::string& message) {
+	void PlatformMacOS::output(const Dbg dbg, const std::string& where, const std::string& message) {
 		if (dbg == Dbg::INFO) {
 			std::cout << "[macOS:info] " + where + ": " + message << std::endl;
 		} else if (dbg == Dbg::WARN) {
@@ -10,7 +10,7 @@ namespace SuperHaxagon {
 	const char* LevelFactory::LEVEL_HEADER = "LEV3.0";
 	const char* LevelFactory::LEVEL_FOOTER = "ENDLEV";
 
-	LevelFactory::LevelFactory(std::istream& stream, std::vector<std::shared_ptr<PatternFactory>>& shared, const Location location, Platform& platform, const size_t levelIndexOffset) {
+	LevelFactory::LevelFactory(std::istream& stream, std::vector<std::shared_ptr<PatternFactory>>& shared, const Location location, Platform& platform) {
 		_location = location;
 
 		if (!readCompare(stream, LEVEL_HEADER)) {
@@ -23,6 +23,7 @@ namespace SuperHaxagon {
 		_mode = readString(stream, platform, _name + " level mode");
 		_creator = readString(stream, platform, _name + " level creator");
 		_music = "/" + readString(stream, platform, _name + " level music");
+		_id = makeId(_name, _difficulty, _mode, _creator);
 
 		const auto numColorsBG1 = read32(stream, 1, 512, platform, "level background 1");
 		_colors[LocColor::BG1].reserve(numColorsBG1);
@@ -43,9 +44,6 @@ namespace SuperHaxagon {
 		_nextIndex = read32(stream, -1, 8192, platform, "next index");
 		_nextTime = readFloat(stream);
 
-		// Negative numbers should remain invalid. -1 usually means load no other level.
-		if (_nextIndex >= 0) _nextIndex += static_cast<int>(levelIndexOffset);
-
 		const auto numPatterns = read32(stream, 1, 512, platform, "level pattern count");
 		for (auto i = 0; i < numPatterns; i++) {
 			auto found = false;
@@ -69,19 +67,37 @@ namespace SuperHaxagon {
 			return;
 		}
 
+		// Each color list also costs a map node, guessed at a few pointers
+		auto bytes = sizeof(LevelFactory) + _patterns.capacity() * sizeof(std::shared_ptr<PatternFactory>);
+		for (const auto* text : {&_name, &_difficulty, &_mode, &_creator, &_music}) bytes += text->capacity();
+		for (const auto& colors : _colors) bytes += colors.second.capacity() * sizeof(Color) + 4 * sizeof(void*);
+		_charge = platform.getMemory().reserve(MemoryTag::LEVELS, bytes, _name + " level");
+		if (!_charge) return;
+
 		_loaded = true;
 	}
 
+	void LevelFactory::offsetNextIndex(const size_t levelIndexOffset) {
+		// Negative numbers should remain invalid. -1 usually means load no other level.
+		if (_nextIndex >= 0) _nextIndex += static_cast<int>(levelIndexOffset);
+	}
+
 	std::unique_ptr<Level> LevelFactory::instantiate(Twist& rng, float renderDistance) const {
 		return std::make_unique<Level>(*this, rng, renderDistance);
 	}
 
-	bool LevelFactory::setHighScore(const int score) {
-		if(score > _highScore) {
-			_highScore = score;
-			return true;
+	uint64_t LevelFactory::makeId(const std::string& name, const std::string& difficulty, const std::string& mode, const std::string& creator) {
+		// 64 bit FNV-1a, with a null between fields so "ab"+"c" and "a"+"bc" differ
+		uint64_t hash = 0xcbf29ce484222325;
+		for (const auto* field : {&name, &difficulty, &mode, &creator}) {
+			for (const auto c : *field) {
+				hash ^= static_cast<unsigned char>(c);
+				hash *= 0x100000001b3;
+			}
+
+			hash *= 0x100000001b3;
 		}
 
-		return false;
+		return hash;
 	}
 }
@@ -20,6 +20,13 @@ namespace SuperHaxagon {
 		if(_sides < MIN_PATTERN_SIDES) _sides = MIN_PATTERN_SIDES;
 
 		const auto numWalls = read32(stream, 1, 1000, platform, _name + " pattern walls");
+
+		// Asked for before the walls are read, so a pack that is too big never gets the chance to allocate
+		const auto bytes = sizeof(PatternFactory) + _name.capacity() + numWalls * sizeof(WallFactory);
+		_charge = platform.getMemory().reserve(MemoryTag::PATTERNS, bytes, _name + " pattern");
+		if (!_charge) return;
+
+		_walls.reserve(numWalls);
 		for (auto i = 0; i < numWalls; i++) _walls.emplace_back(stream, _sides);
 
 		if (!readCompare(stream, PATTERN_FOOTER)) {
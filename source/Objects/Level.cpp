@@ -3,6 +3,7 @@
 #include "Core/Game.hpp"
 #include "Core/Twist.hpp"
 #include "Core/Platform.hpp"
+#include "Core/QualityGovernor.hpp"
 #include "Factories/LevelFactory.hpp"
 #include "Factories/PatternFactory.hpp"
 
@@ -68,6 +69,13 @@ namespace SuperHaxagon {
 			reverseWalls(rng, patternDistDelete, patternDistCreate);
 		}
 
+		// Patterns come and go as the walls move, so the charge follows them
+		if (_charge) {
+			size_t bytes = 0;
+			for (const auto& pattern : _patterns) bytes += sizeof(Pattern) + pattern.getWalls().capacity() * sizeof(Wall);
+			_charge.resize(bytes);
+		}
+
 		// Rotate level
 		if (_rotateToZero) {
 			// Trying to snap back to zero
@@ -99,6 +107,7 @@ namespace SuperHaxagon {
 	}
 
 	void Level::draw(Game& game, const float scale, const float offsetWall) const {
+		SUPER_HAXAGON_ZONE(game.getPlatform().getProfiler(), Zone::LEVEL_DRAW);
 
 		// Calculate colors
 		const auto percentTween = _tweenFrame / static_cast<float>(_factory->getSpeedPulse());
@@ -117,7 +126,7 @@ namespace SuperHaxagon {
 		const auto cursorDistance = SCALE_HEX_LENGTH + SCALE_HUMAN_PADDING;
 
 		// Draw shadows, if supported
-		if (static_cast<int>(game.getPlatform().supports() & Supports::SHADOWS)) {
+		if (game.getQuality().hasShadows()) {
 			const Point offsetFocus = { center.x + shadow.x, center.y + shadow.y };
 			game.drawPatterns(COLOR_SHADOW, offsetFocus, _patterns, _rotation, _sidesTween, offsetWall + _pulse, scale);
 			game.drawRegular(COLOR_SHADOW, offsetFocus, (SCALE_HEX_LENGTH + _pulse) * scale, _rotation, _sidesTween);
@@ -54,7 +54,12 @@ namespace SuperHaxagon {
 	}
 
 	std::vector<Point> Wall::calcPoints(const Point& focus, const float rotation, const float sides, const float offset, const float scale) const {
-		
+		std::vector<Point> quad;
+		calcPoints(quad, focus, rotation, sides, offset, scale);
+		return quad;
+	}
+
+	void Wall::calcPoints(std::vector<Point>& quad, const Point& focus, const float rotation, const float sides, const float offset, const float scale) const {
 		auto tHeight = _height;
 		auto tDistance = _distance + offset;
 		if(tDistance < SCALE_HEX_LENGTH) {//so the distance is never negative as it enters.
@@ -64,14 +69,11 @@ namespace SuperHaxagon {
 
 		tDistance *= scale;
 		tHeight *= scale;
-		std::vector<Point> quad{
-			calcPoint(focus, rotation, -WALL_OVERFLOW, tDistance, sides, _side),
-			calcPoint(focus, rotation, -WALL_OVERFLOW, tDistance + tHeight, sides, _side),
-			calcPoint(focus, rotation, WALL_OVERFLOW, tDistance + tHeight, sides, _side + 1),
-			calcPoint(focus, rotation, WALL_OVERFLOW, tDistance, sides, _side + 1)
-		};
-
-		return quad;
+		quad.resize(4);
+		quad[0] = calcPoint(focus, rotation, -WALL_OVERFLOW, tDistance, sides, _side);
+		quad[1] = calcPoint(focus, rotation, -WALL_OVERFLOW, tDistance + tHeight, sides, _side);
+		quad[2] = calcPoint(focus, rotation, WALL_OVERFLOW, tDistance + tHeight, sides, _side + 1);
+		quad[3] = calcPoint(focus, rotation, WALL_OVERFLOW, tDistance, sides, _side + 1);
 	}
 
 	Point Wall::calcPoint(const Point& focus, const float rotation, const float overflow, const float distance, const float sides, const int side) {
@@ -0,0 +1,132 @@
+#include "States/Calibrate.hpp"
+
+#include "Core/Game.hpp"
+#include "Core/Font.hpp"
+#include "Core/Platform.hpp"
+#include "Core/Structs.hpp"
+#include "States/Menu.hpp"
+#include "States/Quit.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+namespace SuperHaxagon {
+	Calibrate::Calibrate(Game& game, LevelFactory& selected) :
+		_game(game),
+		_platform(game.getPlatform()),
+		_selected(selected) {
+		_audio.reserve(TAPS);
+		_video.reserve(TAPS);
+	}
+
+	Calibrate::~Calibrate() = default;
+
+	void Calibrate::enter() {
+		// The music would be a second beat to tap along to
+		_platform.stopBGM();
+		begin(Phase::AUDIO);
+	}
+
+	std::unique_ptr<State> Calibrate::update(const float dilation) {
+		const auto press = _platform.getPressed();
+		if (press.quit) return std::make_unique<Quit>(_game);
+
+		// Only the moment a button goes down counts, not every frame it is held
+		const auto back = press.back && !_backHeld;
+		const auto select = press.select && !_selectHeld;
+		_backHeld = press.back;
+		_selectHeld = press.select;
+
+		// Leaving early keeps the old calibration
+		if (back) return std::make_unique<Menu>(_game, _selected);
+
+		if (_phase == Phase::DONE) {
+			if (!select) return nullptr;
+			_game.setLatency(_latency);
+			return std::make_unique<Menu>(_game, _selected);
+		}
+
+		_frames += dilation;
+		const auto beat = static_cast<int>(_frames / FRAMES_PER_BEAT);
+		if (beat > _beat) {
+			_beat = beat;
+
+			// The click goes straight out, it is what is being measured
+			if (_phase == Phase::AUDIO) _platform.playSFX(_game.getSFXSelect());
+		}
+
+		if (!select || _beat < SKIP_BEATS) return nullptr;
+
+		// Taps land on whichever beat they are closest to
+		const auto late = _frames - std::round(_frames / FRAMES_PER_BEAT) * FRAMES_PER_BEAT;
+		auto& taps = _phase == Phase::AUDIO ? _audio : _video;
+		taps.push_back(late);
+		if (taps.size() < TAPS) return nullptr;
+
+		if (_phase == Phase::AUDIO) {
+			begin(Phase::VIDEO);
+			return nullptr;
+		}
+
+		// Reaction time is in both, so it cancels out
+		_latency = (median(_video) - median(_audio)) / 60.0f;
+		_latency = std::min(std::max(_latency, -Game::MAX_LATENCY), Game::MAX_LATENCY);
+		begin(Phase::DONE);
+		return nullptr;
+	}
+
+	void Calibrate::drawTop(const float scale) {
+		const auto screen = _platform.getScreenDim();
+		const auto flash = _phase == Phase::VIDEO && std::fmod(_frames, FRAMES_PER_BEAT) < FRAMES_PER_FLASH;
+		_game.drawRect(flash ? COLOR_WHITE : COLOR_BLACK, {0, 0}, screen);
+
+		auto& large = _game.getFontLarge();
+		auto& small = _game.getFontSmall();
+		large.setScale(scale);
+		small.setScale(scale);
+
+		const auto toMs = [](const float seconds) {
+			const auto ms = static_cast<int>(std::lround(seconds * 1000.0f));
+			return (ms > 0 ? "+" : "") + std::to_string(ms) + " MS";
+		};
+
+		std::string action;
+		std::string status;
+		if (_phase == Phase::DONE) {
+			action = "SELECT TO SAVE, BACK TO CANCEL";
+			status = "LATENCY: " + toMs(_latency);
+		} else {
+			action = _phase == Phase::AUDIO ? "TAP SELECT WITH THE CLICK" : "TAP SELECT WITH THE FLASH";
+			const auto& taps = _phase == Phase::AUDIO ? _audio : _video;
+			status = _beat < SKIP_BEATS ? "GET READY" : "TAPS: " + std::to_string(taps.size()) + "/" + std::to_string(TAPS);
+		}
+
+		const auto pad = 3 * scale;
+		const Point posTitle = {screen.x / 2, pad};
+		const Point posAction = {screen.x / 2, screen.y / 2 - small.getHeight() - pad};
+		const Point posStatus = {screen.x / 2, screen.y / 2 + pad};
+		const Point posCurrent = {screen.x / 2, screen.y - small.getHeight() - pad};
+
+		large.draw(COLOR_GREY, posTitle, Alignment::CENTER, "CALIBRATE");
+		small.draw(COLOR_GREY, posAction, Alignment::CENTER, action);
+		small.draw(COLOR_GREY, posStatus, Alignment::CENTER, status);
+		small.draw(COLOR_GREY, posCurrent, Alignment::CENTER, "CURRENT: " + toMs(_game.getLatency()));
+	}
+
+	void Calibrate::drawBot(float) {}
+
+	void Calibrate::begin(const Phase phase) {
+		_phase = phase;
+		_frames = 0;
+		_beat = -1;
+	}
+
+	float Calibrate::median(std::vector<float>& taps) {
+		// A stray early or late tap should not drag the result along
+		std::sort(taps.begin(), taps.end());
+		const auto middle = taps.size() / 2;
+		if (taps.size() % 2) return taps[middle];
+		return (taps[middle - 1] + taps[middle]) / 2.0f;
+	}
+}
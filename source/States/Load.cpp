@@ -1,43 +1,39 @@
 #include "States/Load.hpp"
 
 #include "Core/Game.hpp"
+#include "Core/Jobs.hpp"
 #include "Core/Platform.hpp"
+#include "Core/Scores.hpp"
 #include "Factories/LevelFactory.hpp"
 #include "Factories/PatternFactory.hpp"
 #include "States/Menu.hpp"
 #include "States/Quit.hpp"
 
+#include <chrono>
 #include <memory>
-#include <fstream>
-#include <climits>
 #include <filesystem>
 
 namespace SuperHaxagon {
 	const char* Load::PROJECT_HEADER = "HAX1.1";
 	const char* Load::PROJECT_FOOTER = "ENDHAX";
-	const char* Load::SCORE_HEADER = "SCDB1.0";
-	const char* Load::SCORE_FOOTER = "ENDSCDB";
 
 	Load::Load(Game& game) : _game(game), _platform(game.getPlatform()) {}
 	Load::~Load() = default;
 
-	bool Load::loadLevels(std::istream& stream, Location location) const {
+	bool Load::loadLevels(std::istream& stream, const Location location, Platform& platform, std::vector<std::unique_ptr<LevelFactory>>& levels) {
 		std::vector<std::shared_ptr<PatternFactory>> patterns;
 
-		// Used to make sure that external levels link correctly.
-		const auto levelIndexOffset = _game.getLevels().size();
-
 		if(!readCompare(stream, PROJECT_HEADER)) {
-			_platform.message(Dbg::WARN, "file", "file header invalid!");
+			platform.message(Dbg::WARN, "file", "file header invalid!");
 			return false;
 		}
 
-		const auto numPatterns = read32(stream, 1, 300, _platform, "number of patterns");
+		const auto numPatterns = read32(stream, 1, 300, platform, "number of patterns");
 		patterns.reserve(numPatterns);
 		for (auto i = 0; i < numPatterns; i++) {
-			auto pattern = std::make_shared<PatternFactory>(stream, _platform);
+			auto pattern = std::make_shared<PatternFactory>(stream, platform);
 			if (!pattern->isLoaded()) {
-				_platform.message(Dbg::WARN, "file", "a pattern failed to load");
+				platform.message(Dbg::WARN, "file", "a pattern failed to load");
 				return false;
 			}
 
@@ -45,56 +41,23 @@ namespace SuperHaxagon {
 		}
 
 		if (patterns.empty()) {
-			_platform.message(Dbg::WARN, "file", "no patterns loaded");
+			platform.message(Dbg::WARN, "file", "no patterns loaded");
 			return false;
 		}
 
-		const auto numLevels = read32(stream, 1, 300, _platform, "number of levels");
+		const auto numLevels = read32(stream, 1, 300, platform, "number of levels");
 		for (auto i = 0; i < numLevels; i++) {
-			auto level = std::make_unique<LevelFactory>(stream, patterns, location, _platform, levelIndexOffset);
+			auto level = std::make_unique<LevelFactory>(stream, patterns, location, platform);
 			if (!level->isLoaded()) {
-				_platform.message(Dbg::WARN, "file", "a level failed to load");
+				platform.message(Dbg::WARN, "file", "a level failed to load");
 				return false;
 			}
 
-			_game.addLevel(std::move(level));
+			levels.emplace_back(std::move(level));
 		}
 
 		if(!readCompare(stream, PROJECT_FOOTER)) {
-			_platform.message(Dbg::WARN, "load", "file footer invalid");
-			return false;
-		}
-
-		return true;
-	}
-
-	bool Load::loadScores(std::istream& stream) const {
-		if (!stream) {
-			_platform.message(Dbg::INFO, "scores", "no score database");
-			return true;
-		}
-
-		if (!readCompare(stream, SCORE_HEADER)) {
-			_platform.message(Dbg::WARN,"scores", "score header invalid, skipping scores");
-			return true; // If there is no score database silently fail.
-		}
-
-		const auto numScores = read32(stream, 1, 300, _platform, "number of scores");
-		for (auto i = 0; i < numScores; i++) {
-			auto name = readString(stream, _platform, "score level name");
-			auto difficulty = readString(stream, _platform, "score level difficulty");
-			auto mode = readString(stream, _platform, "score level mode");
-			auto creator = readString(stream, _platform, "score level creator");
-			const auto score = read32(stream, 0, INT_MAX, _platform, "score");
-			for (const auto& level : _game.getLevels()) {
-				if (level->getName() == name && level->getDifficulty() == difficulty && level->getMode() == mode && level->getCreator() == creator) {
-					level->setHighScore(score);
-				}
-			}
-		}
-
-		if (!readCompare(stream, SCORE_FOOTER)) {
-			_platform.message(Dbg::WARN,"scores", "file footer invalid, db broken");
+			platform.message(Dbg::WARN, "load", "file footer invalid");
 			return false;
 		}
 
@@ -109,17 +72,43 @@ namespace SuperHaxagon {
 			auto files = std::filesystem::directory_iterator(_platform.getPath("/", Location::USER));
 			for (const auto& file : files) {
 				if (file.path().extension() != ".haxagon") continue;
-				_platform.message(Dbg::INFO, "load", "found " + file.path().string());
+				if (_platform.isLogged(Dbg::INFO)) _platform.message(Dbg::INFO, "load", "found " + file.path().string());
 				levels.emplace_back(std::pair<Location, std::string>(Location::USER, file.path().string()));
 			}
 		}
 
-		for (const auto& pair : levels) {
-			const auto& path = pair.second;
-			const auto location = pair.first;
-			auto file = _platform.openFile(path, location);
-			if (!file) continue;
-			loadLevels(*file, location);
+		// Files are read side by side, then added in the order they were found
+		struct Pack {
+			std::vector<std::unique_ptr<LevelFactory>> levels;
+			float seconds = -1.0f;
+		};
+
+		std::vector<Pack> packs(levels.size());
+		{
+			SUPER_HAXAGON_SPAN(_platform.getProfiler().getTrace(), Trace::Track::GAME, "load levels", std::to_string(levels.size()) + " files");
+			_game.getJobs().parallelFor(levels.size(), 1, [this, &levels, &packs](const size_t begin, const size_t end) {
+				for (auto i = begin; i < end; i++) {
+					const auto& path = levels[i].second;
+					const auto location = levels[i].first;
+					SUPER_HAXAGON_SPAN(_platform.getProfiler().getTrace(), Trace::Track::JOBS, "load levels", path);
+					const auto start = std::chrono::steady_clock::now();
+					auto file = _platform.openFile(path, location);
+					if (!file) continue;
+					loadLevels(*file, location, _platform, packs[i].levels);
+					packs[i].seconds = std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count();
+				}
+			});
+		}
+
+		for (auto& pack : packs) {
+			// Used to make sure that external levels link correctly.
+			const auto levelIndexOffset = _game.getLevels().size();
+			for (auto& level : pack.levels) {
+				level->offsetNextIndex(levelIndexOffset);
+				_game.addLevel(std::move(level));
+			}
+
+			if (pack.seconds >= 0) _platform.getMetrics().getLevelLoads().observe(pack.seconds);
 		}
 
 		if (_game.getLevels().empty()) {
@@ -127,8 +116,9 @@ namespace SuperHaxagon {
 			return;
 		}
 
-		std::ifstream scores(_platform.getPath("/scores.db", Location::USER), std::ios::in | std::ios::binary);
-		if (!loadScores(scores)) return;
+		_platform.getMemory().report();
+		if (!_game.getScores().load()) return;
+		if (static_cast<int>(_platform.supports() & Supports::FILESYSTEM)) _game.loadLatency();
 
 		_loaded = true;
 	}
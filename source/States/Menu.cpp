@@ -3,13 +3,18 @@
 #include "Core/Game.hpp"
 #include "Core/Metadata.hpp"
 #include "Core/Font.hpp"
+#include "Core/History.hpp"
 #include "Core/Platform.hpp"
+#include "Core/QualityGovernor.hpp"
+#include "Core/Scores.hpp"
 #include "Factories/LevelFactory.hpp"
+#include "States/Calibrate.hpp"
 #include "States/Play.hpp"
 #include "States/Quit.hpp"
 
 #include <array>
 #include <algorithm>
+#include <iterator>
 
 namespace SuperHaxagon {
 	Menu::Menu(Game& game, LevelFactory& selected) :
@@ -33,7 +38,8 @@ namespace SuperHaxagon {
 		_game.setSkew(0.0);
 		_game.setShadowAuto(false);
 		_game.loadBGMAudio("/werq", Location::ROM, false);
-		_platform.playSFX(_game.getSFXHexagon());
+		_game.playSFX(_game.getSFXHexagon());
+		prefetch();
 	}
 
 	std::unique_ptr<State> Menu::update(const float dilation) {
@@ -41,13 +47,29 @@ namespace SuperHaxagon {
 
 		if (press.quit) return std::make_unique<Quit>(_game);
 
+		// Select and back act when they go down, not for as long as they are held
+		const auto select = press.select && !_selectHeld;
+		const auto back = press.back && !_backHeld;
+		_selectHeld = press.select;
+		_backHeld = press.back;
+
+		// The level starts once its BGM is ready to go
+		if (_starting) {
+			if (_game.isBGMLoading()) return nullptr;
+			auto& level = **_selected;
+			return std::make_unique<Play>(_game, level, level, 0.0f);
+		}
+
 		if (!_transitionDirection) {
-			if (press.select) {
-				auto& level = **_selected;
-				_game.loadBGMAudio(level.getMusic(), level.getLocation(), true);
-				return std::make_unique<Play>(_game, level, level, 0.0f);
+			if (select) {
+				const auto& level = **_selected;
+				_game.loadBGMAudio(level.getMusic(), level.getLocation(), true, true);
+				_starting = true;
+				return nullptr;
 			}
 
+			if (back) return std::make_unique<Calibrate>(_game, **_selected);
+
 			if (press.right) {
 				_transitionDirection = 1;
 				++_selected;
@@ -59,7 +81,8 @@ namespace SuperHaxagon {
 			}
 
 			if (_transitionDirection) {
-				_platform.playSFX(_game.getSFXSelect());
+				_game.playSFX(_game.getSFXSelect());
+				prefetch();
 				for (auto i = COLOR_LOCATION_FIRST; i != COLOR_LOCATION_LAST; i++) {
 					const auto location = static_cast<LocColor>(i);
 
@@ -146,7 +169,7 @@ namespace SuperHaxagon {
 
 		
 		// Shadows, if supported
-		if (static_cast<int>(_platform.supports() & Supports::SHADOWS)) {
+		if (_game.getQuality().hasShadows()) {
 			_game.drawRegular(COLOR_SHADOW, offsetFocus, SCALE_HEX_LENGTH * SCALE_MENU * scale, rotation, 6.0);
 			_game.drawCursor(COLOR_SHADOW, offsetFocus, TAU / 4.0f, 0, SCALE_HEX_LENGTH + SCALE_HUMAN_PADDING + 4, scale * SCALE_MENU * 0.75f);
 		}
@@ -164,7 +187,9 @@ namespace SuperHaxagon {
 
 		// Actual text
 		auto& level = **_selected;
-		auto scoreTime = "BEST: " + getTime(static_cast<float>(level.getHighScore()));
+		auto scoreTime = "BEST: " + getTime(static_cast<float>(_game.getScores().get(level.getId())));
+		const auto& stats = _game.getHistory().getStats(level.getId());
+		if (stats.attempts) scoreTime += " AVG: " + getTime(stats.getAverage()) + " RUNS: " + std::to_string(stats.attempts);
 		auto diff = "DIFF: " + level.getDifficulty();
 		auto mode = "MODE: " + level.getMode();
 		auto auth = "AUTH: " + level.getCreator();
@@ -195,7 +220,9 @@ namespace SuperHaxagon {
 			{0, infoSize.y}
 		};
 
-		_platform.drawPoly(COLOR_TRANSPARENT, info);
+		// Panels behind text are the first thing to go on slow hardware
+		const auto panels = _game.getQuality().hasTextPanels();
+		if (panels) _platform.drawPoly(COLOR_TRANSPARENT, info);
 
 		// Score block with triangle
 		Point timeSize = {small.getWidth(scoreTime) + pad * 2, small.getHeight() + pad * 2};
@@ -209,7 +236,7 @@ namespace SuperHaxagon {
 			{0,  screenHeight},
 		};
 
-		_platform.drawPoly(COLOR_TRANSPARENT, time);
+		if (panels) _platform.drawPoly(COLOR_TRANSPARENT, time);
 
 		large.draw(COLOR_WHITE, posTitle, Alignment::LEFT, level.getName());
 		small.draw(COLOR_GREY, posDifficulty, Alignment::LEFT, diff);
@@ -219,4 +246,14 @@ namespace SuperHaxagon {
 	}
 
 	void Menu::drawBot(float) {}
+
+	void Menu::prefetch() const {
+		// Whichever way the player goes next, its music is already open
+		const auto& levels = _game.getLevels();
+		const auto next = std::next(_selected) == levels.end() ? levels.begin() : std::next(_selected);
+		const auto previous = std::prev(_selected == levels.begin() ? levels.end() : _selected);
+		for (const auto& level : {_selected, next, previous}) {
+			_game.prefetchBGM((*level)->getMusic(), (*level)->getLocation());
+		}
+	}
 }
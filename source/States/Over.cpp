@@ -3,17 +3,13 @@
 #include "Core/Game.hpp"
 #include "Core/Platform.hpp"
 #include "Core/Font.hpp"
+#include "Core/Scores.hpp"
 #include "Factories/LevelFactory.hpp"
 #include "Objects/Level.hpp"
-#include "States/Load.hpp"
 #include "States/Menu.hpp"
 #include "States/Play.hpp"
 #include "States/Quit.hpp"
 
-#include <cstring>
-#include <ostream>
-#include <fstream>
-
 namespace SuperHaxagon {
 
 	Over::Over(Game& game, std::unique_ptr<Level> level, LevelFactory& selected, const float score, std::string text) :
@@ -23,32 +19,16 @@ namespace SuperHaxagon {
 		_level(std::move(level)),
 		_text(std::move(text)),
 		_score(score) {
-		_high = _selected.setHighScore(static_cast<int>(score));
+		_high = _game.getScores().set(_selected.getId(), static_cast<int>(score));
 	}
 
 	Over::~Over() = default;
 
 	void Over::enter() {
-		_platform.playSFX(_game.getSFXOver());
-
-		std::ofstream scores(_platform.getPath("/scores.db", Location::USER), std::ios::out | std::ios::binary);
-
-		if (!scores) return;
-
-		scores.write(Load::SCORE_HEADER, strlen(Load::SCORE_HEADER));
-		auto levels = static_cast<uint32_t>(_game.getLevels().size());
-		scores.write(reinterpret_cast<char*>(&levels), sizeof(levels));
+		_game.playSFX(_game.getSFXOver());
 
-		for (const auto& lev : _game.getLevels()) {
-			writeString(scores, lev->getName());
-			writeString(scores, lev->getDifficulty());
-			writeString(scores, lev->getMode());
-			writeString(scores, lev->getCreator());
-			uint32_t highSc = lev->getHighScore();
-			scores.write(reinterpret_cast<char*>(&highSc), sizeof(highSc));
-		}
-
-		scores.write(Load::SCORE_FOOTER, strlen(Load::SCORE_FOOTER));
+		// Nothing changed, so there is nothing to save
+		if (_high) _game.getScores().record(_selected.getId());
 	}
 
 	std::unique_ptr<State> Over::update(const float dilation) {
@@ -65,14 +45,19 @@ namespace SuperHaxagon {
 
 		if(_frames >= FRAMES_PER_GAME_OVER) {
 			_level->clearPatterns();
-			if (press.select) {
+			if (!_loading && press.select) {
 				// If the level we are playing is not the same as the index, we need to load
 				// the original music
 				if (_selected.getMusic() != _level->getLevelFactory().getMusic()) {
 					_game.loadBGMAudio(_selected.getMusic(), _selected.getLocation(), true);
 				}
 
-				// Go back to the original level
+				_loading = true;
+			}
+
+			// Go back to the original level once its music is ready
+			if (_loading) {
+				if (_game.isBGMLoading()) return nullptr;
 				return std::make_unique<Play>(_game, _selected, _selected, 0.0f);
 			}
 
@@ -116,7 +101,7 @@ namespace SuperHaxagon {
 			const auto pulse = interpolateColor(PULSE_LOW, PULSE_HIGH, percent);
 			small.draw(pulse, posBest, Alignment::CENTER, "NEW RECORD!");
 		} else {
-			const auto score = _selected.getHighScore();
+			const auto score = _game.getScores().get(_selected.getId());
 			const auto textBest = std::string("BEST: ") + getTime(static_cast<float>(score));
 			small.draw(COLOR_WHITE, posBest, Alignment::CENTER, textBest);
 		}
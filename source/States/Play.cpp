@@ -3,7 +3,11 @@
 #include "Core/Game.hpp"
 #include "Core/Metadata.hpp"
 #include "Core/Font.hpp"
+#include "Core/History.hpp"
 #include "Core/Platform.hpp"
+#include "Core/QualityGovernor.hpp"
+#include "Core/Scores.hpp"
+#include "Core/Twist.hpp"
 #include "Core/AudioPlayer.hpp"
 #include "Factories/LevelFactory.hpp"
 #include "Objects/Level.hpp"
@@ -21,20 +25,30 @@ namespace SuperHaxagon {
 		_platform(game.getPlatform()),
 		_factory(factory),
 		_selected(selected),
+		_seed(game.getTwister().reseed()),
 		_level(factory.instantiate(game.getTwister(), SCALE_BASE_DISTANCE)),
-		_score(startScore)
-	{}
+		_score(startScore),
+		_eventSpin(Metadata::getEvent("S")),
+		_eventInvert(Metadata::getEvent("I")),
+		_eventPulseLarge(Metadata::getEvent("BL")),
+		_eventPulseSmall(Metadata::getEvent("BS"))
+	{
+		_level->setCharge(_platform.getMemory().charge(MemoryTag::RUNTIME, 0));
+	}
 
 	Play::~Play() = default;
 
 	void Play::enter() {
 		auto* bgm = _platform.getBGM();
 		if (bgm) bgm->play();
-		_platform.playSFX(_game.getSFXBegin());
+		_game.playSFX(_game.getSFXBegin());
 		_game.setShadowAuto(true);
+		_platform.getMetrics().levelPlayed();
+		_platform.setSampling(true);
 	}
 
 	void Play::exit() {
+		_platform.setSampling(false);
 		auto* bgm = _platform.getBGM();
 		if (bgm) bgm->pause();
 	}
@@ -58,22 +72,33 @@ namespace SuperHaxagon {
 			const auto time = bgm ? bgm->getTime() : 0.0f;
 
 			// Apply effects. More can be added here if needed.
-			if (metadata.getMetadata(time, "S")) _level->spin();
-			if (metadata.getMetadata(time, "I")) _level->invertBG();
-			if (metadata.getMetadata(time, "BL")) _level->pulse(1.1f);
-			if (metadata.getMetadata(time, "BS")) _level->pulse(0.7f);
+			const auto events = metadata.advance(time + _game.getLatency());
+			if (events & _eventSpin) _level->spin();
+			if (events & _eventInvert) _level->invertBG();
+			if (events & _eventPulseLarge) _level->pulse(1.1f);
+			if (events & _eventPulseSmall) _level->pulse(0.7f);
 		}
 
+		_dilationTotal += dilation;
+		_updates++;
+
 		// Update level
 		const auto previousFrame = _level->getFrame();
-		_level->update(_game.getTwister(), SCALE_HEX_LENGTH, maxRenderDistance, dilation);
+		{
+			SUPER_HAXAGON_ZONE(_platform.getProfiler(), Zone::LEVEL_UPDATE);
+			_level->update(_game.getTwister(), SCALE_HEX_LENGTH, maxRenderDistance, dilation);
+		}
 
 		// Button presses
 		const auto pressed = _platform.getPressed();
 
 		// Check collision
 		const auto cursorDistance = SCALE_HEX_LENGTH + SCALE_HUMAN_PADDING + SCALE_HUMAN_HEIGHT;
-		const auto hit = _level->collision(cursorDistance, dilation);
+		auto hit = Movement::CAN_MOVE;
+		{
+			SUPER_HAXAGON_ZONE(_platform.getProfiler(), Zone::LEVEL_COLLISION);
+			hit = _level->collision(cursorDistance, dilation);
+		}
 
 		// Keys
 		if(pressed.back || hit == Movement::DEAD) {
@@ -84,6 +109,7 @@ namespace SuperHaxagon {
 			    (_factory.getMode() == "???" || _factory.getMode() == "ORIGINAL")) {
 				// Play the super special win animation if you are on the last level without selecting it
 				// Congrats, you just won the game!
+				record(RunEnd::WON);
 				return std::make_unique<Win>(_game, std::move(_level), _selected, _score, "WONDERFUL");
 			}
 
@@ -92,13 +118,16 @@ namespace SuperHaxagon {
 			    _factory.getDifficulty() == "SPOILERS" &&
 			    _factory.getMode() == "(DUH)") {
 				// Cheater
+				record(RunEnd::WON);
 				return std::make_unique<Win>(_game, std::move(_level), _selected, 0.0f, "CHEATER");
 			}
 
+			record(hit == Movement::DEAD ? RunEnd::DIED : RunEnd::BACK);
 			return std::make_unique<Over>(_game, std::move(_level), _selected, _score, "GAME OVER");
 		}
 
 		if (pressed.quit) {
+			record(RunEnd::QUIT);
 			return std::make_unique<Quit>(_game);
 		}
 
@@ -110,12 +139,10 @@ namespace SuperHaxagon {
 			return std::make_unique<Transition>(_game, std::move(_level), _selected, _score);
 		}
 
-		// Process movement
-		if (pressed.left && hit != Movement::CANNOT_MOVE_LEFT) {
-			_level->left(dilation);
-		} else if (pressed.right && hit != Movement::CANNOT_MOVE_RIGHT) {
-			_level->right(dilation);
-		}
+		// Process movement, for only as much of the frame as each was held
+		const auto held = _platform.getHeld();
+		if (held.left > 0 && hit != Movement::CANNOT_MOVE_LEFT) _level->left(dilation * held.left);
+		if (held.right > 0 && hit != Movement::CANNOT_MOVE_RIGHT) _level->right(dilation * held.right);
 
 		// Make sure the cursor doesn't extend too far
 		_level->clamp();
@@ -126,12 +153,23 @@ namespace SuperHaxagon {
 		const auto* lastScoreText = getScoreText(static_cast<int>(previousFrame), false);
 		if (lastScoreText != getScoreText(static_cast<int>(_level->getFrame()), false)) {
 			_level->increaseMultiplier();
-			_platform.playSFX(_game.getSFXLevelUp());
+			_game.playSFX(_game.getSFXLevelUp());
 		}
 
 		return nullptr;
 	}
 
+	void Play::record(const RunEnd cause) const {
+		Run run{};
+		run.level = _selected.getId();
+		run.seed = _seed;
+		run.duration = _score;
+		run.deathFrame = static_cast<uint32_t>(_level->getFrame());
+		run.cause = cause;
+		run.frameTime = _updates ? _dilationTotal / static_cast<float>(_updates) * 1000.0f / 60.0f : 0.0f;
+		_game.getHistory().record(run);
+	}
+
 	void Play::drawTop(const float scale) {
 		_level->draw(_game, scale, 0);
 	}
@@ -169,7 +207,8 @@ namespace SuperHaxagon {
 			{0, levelUpBkgSize.y},
 		};
 
-		_platform.drawPoly(COLOR_TRANSPARENT, levelUpBkg);
+		const auto panels = _game.getQuality().hasTextPanels();
+		if (panels) _platform.drawPoly(COLOR_TRANSPARENT, levelUpBkg);
 		small.draw(COLOR_WHITE, levelUpPosText, Alignment::LEFT, levelUp);
 
 		// Draw the current score
@@ -183,7 +222,7 @@ namespace SuperHaxagon {
 		auto drawHigh = false;
 		const auto originalY = scoreBkgSize.y;
 		const auto heightBar = 2 * scale;
-		const auto highScore = static_cast<float>(_selected.getHighScore());
+		const auto highScore = static_cast<float>(_game.getScores().get(_selected.getId()));
 
 		// Adjust background size to accommodate for new record or bar
 		const auto* const recordText = "NEW RECORD!";
@@ -209,7 +248,7 @@ namespace SuperHaxagon {
 			{screenWidth - scoreBkgSize.x, scoreBkgSize.y}
 		};
 
-		_platform.drawPoly(COLOR_TRANSPARENT, scoreBkg);
+		if (panels) _platform.drawPoly(COLOR_TRANSPARENT, scoreBkg);
 		small.draw(COLOR_WHITE, scorePosText, Alignment::LEFT, textScore);
 
 		if (drawBar) {
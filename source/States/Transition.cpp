@@ -2,6 +2,7 @@
 
 #include "Core/Game.hpp"
 #include "Core/Platform.hpp"
+#include "Core/QualityGovernor.hpp"
 #include "Core/Font.hpp"
 #include "Factories/LevelFactory.hpp"
 #include "Objects/Level.hpp"
@@ -21,7 +22,7 @@ namespace SuperHaxagon {
 	Transition::~Transition() = default;
 
 	void Transition::enter() {
-		_platform.playSFX(_game.getSFXWonderful());
+		_game.playSFX(_game.getSFXWonderful());
 	}
 
 	std::unique_ptr<State> Transition::update(const float dilation) {
@@ -45,10 +46,12 @@ namespace SuperHaxagon {
 
 			// We want to keep the current music playing if we are going to start
 			// the next level with the same music
-			if (_selected.getMusic() != factory.getMusic()) {
-				_game.loadBGMAudio(factory.getMusic(), factory.getLocation(), true);
+			if (!_loading && _selected.getMusic() != factory.getMusic()) {
+				_game.loadBGMAudio(factory.getMusic(), factory.getLocation(), true, true);
+				_loading = true;
 			}
-			
+
+			if (_game.isBGMLoading()) return nullptr;
 			return std::make_unique<Play>(_game, factory, _selected, _score);
 		}
 
@@ -79,7 +82,7 @@ namespace SuperHaxagon {
 
 		const auto percent = getPulse(_frames, Play::PULSE_TIME, 0);
 		const auto pulse = interpolateColor(PULSE_LOW, PULSE_HIGH, percent);
-		_platform.drawPoly(COLOR_TRANSPARENT, trap);
+		if (_game.getQuality().hasTextPanels()) _platform.drawPoly(COLOR_TRANSPARENT, trap);
 		large.draw(pulse, posText, Alignment::CENTER, text);
 	}
 }
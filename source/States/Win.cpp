@@ -20,7 +20,15 @@ namespace SuperHaxagon {
 		_selected(selected),
 		_level(std::move(level)),
 		_score(score),
-		_text(std::move(text)) {
+		_text(std::move(text)),
+		_eventHyper(Metadata::getEvent("HYPER")),
+		_eventSurround(Metadata::getEvent("PSURROUND")),
+		_eventPulseLarge(Metadata::getEvent("BL")),
+		_eventPulseSmall(Metadata::getEvent("BS")),
+		_eventInvert(Metadata::getEvent("I")),
+		_eventCredits(Metadata::getEvent("C")) {
+
+		for (auto i = LEVEL_HARD; i <= LEVEL_VOID; i++) _eventLevels[i] = Metadata::getEvent("L" + std::to_string(i));
 
 		// First make sure that all of the levels exist
 		for (auto i = LEVEL_HARD; i <= LEVEL_VOID; i++) {
@@ -80,6 +88,8 @@ namespace SuperHaxagon {
 			return std::make_unique<Quit>(_game);
 		}
 
+		if (_game.isBGMLoading()) return nullptr;
+
 		if (!_game.getBGMMetadata()) {
 			_platform.message(Dbg::FATAL, "win", "metadata failed to load");
 			return std::make_unique<Quit>(_game);
@@ -100,10 +110,11 @@ namespace SuperHaxagon {
 
 		// Keep track of time so we know when the song loops
 		_lastTime = time;
+		const auto events = metadata.advance(time + _game.getLatency());
 
 		// Check for level transition labels
 		for (auto i = LEVEL_HARD; i <= LEVEL_VOID; i++) {
-			if (!metadata.getMetadata(time, "L" + std::to_string(i))) continue;
+			if (!(events & _eventLevels[i])) continue;
 
 			const auto& factory = _game.getLevels()[i].get();
 			_level->setWinFactory(factory);
@@ -122,16 +133,16 @@ namespace SuperHaxagon {
 		}
 
 		// Apply effects. More can be added here if needed.
-		if (metadata.getMetadata(time, "HYPER")) {
+		if (events & _eventHyper) {
 			_level->setWinFrame(60.0 * 60.0);
 			_level->spin();
 		}
 
-		if (metadata.getMetadata(time, "PSURROUND")) _level->getPatterns().emplace_front(*_surround);
-		if (metadata.getMetadata(time, "BL")) _level->pulse(1.0);
-		if (metadata.getMetadata(time, "BS")) _level->pulse(0.5);
-		if (metadata.getMetadata(time, "I")) _level->invertBG();
-		if (metadata.getMetadata(time, "C")) {
+		if (events & _eventSurround) _level->getPatterns().emplace_front(*_surround);
+		if (events & _eventPulseLarge) _level->pulse(1.0);
+		if (events & _eventPulseSmall) _level->pulse(0.5);
+		if (events & _eventInvert) _level->invertBG();
+		if (events & _eventCredits) {
 			_index++;
 			_timer = CREDITS_TIMER;
 			if (_index >= _credits.size()) _index = _credits.size() - 1;
@@ -141,6 +152,7 @@ namespace SuperHaxagon {
 
 		const auto maxRenderDistance = SCALE_BASE_DISTANCE * (_game.getScreenDimMax() / 400);
 		auto& level = *_level;
+		SUPER_HAXAGON_ZONE(_platform.getProfiler(), Zone::LEVEL_UPDATE);
 		level.update(_game.getTwister(), maxRenderDistance, 0, dilation);
 		
 		return nullptr;
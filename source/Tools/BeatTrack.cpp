@@ -0,0 +1,437 @@
+// Finds the beats in OGG songs and writes a label file next to each one in
+// the format Metadata reads, so songs that come without a timeline still
+// pulse and spin.
+//
+// Every beat gets BS. In the louder half of the song the first beat of each
+// bar gets BL and I instead, and a bar that is much louder than the few
+// before it gets S as well. Songs are analysed in parallel, one per core.
+//
+// Usage: BeatTrack [-f] song.ogg|directory...
+//        -f overwrites label files that already exist
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <stb_vorbis.c>
+
+static constexpr float PI = 3.14159265358979f;
+
+// The window should be around 46 ms whatever the rate, and is hopped by a quarter of it
+static constexpr float WINDOW_SECONDS = 0.046f;
+static constexpr size_t HOPS_PER_WINDOW = 4;
+
+// Below this a kick drum is all there is
+static constexpr float LOW_HZ = 150.0f;
+
+// The bundled songs are all between 135 and 165 BPM, so ties go to around there
+static constexpr float MIN_BPM = 60.0f;
+static constexpr float MAX_BPM = 200.0f;
+static constexpr float PREFERRED_BPM = 145.0f;
+
+// How hard the tracker holds on to the tempo over following the onsets
+static constexpr float TIGHTNESS = 100.0f;
+
+static constexpr int BEATS_PER_BAR = 4;
+static constexpr int BARS_BETWEEN_SPINS = 8;
+static constexpr int SPIN_HISTORY_BARS = 4;
+static constexpr float SPIN_RISE = 2.0f;
+
+// Beats quieter than this, relative to the loudest frame, are leading or trailing silence
+static constexpr float SILENCE = 1e-4f;
+
+// Radix 2, with the real and imaginary parts in separate arrays so the
+// butterflies are straight runs of float math the compiler can vectorise.
+class Fft {
+public:
+	explicit Fft(const size_t size) : _size(size), _reverse(size), _cos(size / 2), _sin(size / 2) {
+		auto bits = 0;
+		while ((static_cast<size_t>(1) << bits) < size) bits++;
+		for (size_t i = 0; i < size; i++) {
+			size_t reversed = 0;
+			for (auto bit = 0; bit < bits; bit++) reversed |= ((i >> bit) & 1) << (bits - 1 - bit);
+			_reverse[i] = reversed;
+		}
+
+		for (size_t i = 0; i < size / 2; i++) {
+			_cos[i] = std::cos(-2.0f * PI * static_cast<float>(i) / static_cast<float>(size));
+			_sin[i] = std::sin(-2.0f * PI * static_cast<float>(i) / static_cast<float>(size));
+		}
+	}
+
+	void transform(float* re, float* im) const {
+		for (size_t i = 0; i < _size; i++) {
+			const auto j = _reverse[i];
+			if (j <= i) continue;
+			std::swap(re[i], re[j]);
+			std::swap(im[i], im[j]);
+		}
+
+		for (size_t half = 1; half < _size; half *= 2) {
+			const auto stride = _size / (half * 2);
+			for (size_t start = 0; start < _size; start += half * 2) {
+				auto* reA = re + start;
+				auto* imA = im + start;
+				auto* reB = reA + half;
+				auto* imB = imA + half;
+				for (size_t k = 0; k < half; k++) {
+					const auto wr = _cos[k * stride];
+					const auto wi = _sin[k * stride];
+					const auto tr = reB[k] * wr - imB[k] * wi;
+					const auto ti = reB[k] * wi + imB[k] * wr;
+					reB[k] = reA[k] - tr;
+					imB[k] = imA[k] - ti;
+					reA[k] += tr;
+					imA[k] += ti;
+				}
+			}
+		}
+	}
+
+private:
+	size_t _size;
+	std::vector<size_t> _reverse;
+	std::vector<float> _cos;
+	std::vector<float> _sin;
+};
+
+// One value per hop
+struct Analysis {
+	int rate = 0;
+	size_t window = 0;
+	size_t hop = 0;
+	std::vector<float> flux;
+	std::vector<float> low;
+	std::vector<float> energy;
+
+	float getTime(const size_t frame) const {
+		return static_cast<float>(frame * hop + window / 2) / static_cast<float>(rate);
+	}
+};
+
+// Spectral flux of the log magnitude, for the whole song and for the kick drum alone
+static bool analyse(const std::string& path, Analysis& analysis) {
+	auto error = 0;
+	auto* vorbis = stb_vorbis_open_filename(path.c_str(), &error, nullptr);
+	if (!vorbis) return false;
+
+	const auto info = stb_vorbis_get_info(vorbis);
+	const auto channels = info.channels;
+	analysis.rate = static_cast<int>(info.sample_rate);
+	analysis.window = 1;
+	while (static_cast<float>(analysis.window) < WINDOW_SECONDS * static_cast<float>(analysis.rate)) analysis.window *= 2;
+	analysis.hop = analysis.window / HOPS_PER_WINDOW;
+
+	const auto window = analysis.window;
+	const auto bins = window / 2 + 1;
+	const auto lowBins = std::min(bins, static_cast<size_t>(LOW_HZ * static_cast<float>(window) / static_cast<float>(analysis.rate)) + 1);
+	const Fft fft(window);
+
+	std::vector<float> hann(window);
+	for (size_t i = 0; i < window; i++) hann[i] = 0.5f - 0.5f * std::cos(2.0f * PI * static_cast<float>(i) / static_cast<float>(window));
+
+	std::vector<float> re(window);
+	std::vector<float> im(window);
+	std::vector<float> magnitude(bins, 0.0f);
+	std::vector<float> previous(bins, 0.0f);
+	std::vector<short> decoded(4096 * std::max(channels, 1));
+	std::vector<float> mono;
+
+	while (true) {
+		const auto frames = stb_vorbis_get_samples_short_interleaved(vorbis, channels, decoded.data(), static_cast<int>(decoded.size()));
+		if (frames <= 0) break;
+
+		for (auto i = 0; i < frames; i++) {
+			auto sum = 0.0f;
+			for (auto c = 0; c < channels; c++) sum += decoded[i * channels + c];
+			mono.push_back(sum / (32768.0f * static_cast<float>(channels)));
+		}
+
+		size_t used = 0;
+		while (mono.size() - used >= window) {
+			const auto* samples = mono.data() + used;
+			auto energy = 0.0f;
+			for (size_t i = 0; i < window; i++) {
+				re[i] = samples[i] * hann[i];
+				im[i] = 0.0f;
+				energy += samples[i] * samples[i];
+			}
+
+			fft.transform(re.data(), im.data());
+
+			auto flux = 0.0f;
+			auto low = 0.0f;
+			for (size_t i = 0; i < bins; i++) {
+				magnitude[i] = std::log1p(100.0f * std::sqrt(re[i] * re[i] + im[i] * im[i]));
+				const auto rise = std::max(0.0f, magnitude[i] - previous[i]);
+				flux += rise;
+				if (i < lowBins) low += rise;
+			}
+
+			std::swap(magnitude, previous);
+			analysis.flux.push_back(flux);
+			analysis.low.push_back(low);
+			analysis.energy.push_back(energy / static_cast<float>(window));
+			used += analysis.hop;
+		}
+
+		mono.erase(mono.begin(), mono.begin() + static_cast<std::ptrdiff_t>(used));
+	}
+
+	stb_vorbis_close(vorbis);
+	return !analysis.flux.empty();
+}
+
+// Takes away the local average so only the peaks are left, in standard deviations
+static std::vector<float> normalise(const std::vector<float>& flux, const size_t radius) {
+	std::vector<double> sums(flux.size() + 1, 0.0);
+	for (size_t i = 0; i < flux.size(); i++) sums[i + 1] = sums[i] + flux[i];
+
+	std::vector<float> envelope(flux.size());
+	auto square = 0.0;
+	for (size_t i = 0; i < flux.size(); i++) {
+		const auto first = i > radius ? i - radius : 0;
+		const auto last = std::min(flux.size(), i + radius + 1);
+		const auto mean = (sums[last] - sums[first]) / static_cast<double>(last - first);
+		envelope[i] = std::max(0.0f, flux[i] - static_cast<float>(mean));
+		square += envelope[i] * envelope[i];
+	}
+
+	const auto deviation = static_cast<float>(std::sqrt(square / static_cast<double>(flux.size())));
+	if (deviation > 0.0f) for (auto& value : envelope) value /= deviation;
+	return envelope;
+}
+
+// Beat period in hops from the autocorrelation of the envelope. Each lag also
+// scores half of what twice and half the lag do, because bars and off beats
+// repeat along with the beat, and the result leans towards PREFERRED_BPM.
+static float findPeriod(const std::vector<float>& envelope, const float hopsPerSecond) {
+	const auto minLag = static_cast<size_t>(hopsPerSecond * 60.0f / MAX_BPM);
+	const auto maxLag = static_cast<size_t>(hopsPerSecond * 60.0f / MIN_BPM) + 1;
+	if (minLag < 1 || maxLag * 2 + 1 >= envelope.size()) return hopsPerSecond * 60.0f / PREFERRED_BPM;
+
+	// Onsets rarely land on the same hop every time, so they are blurred a little first
+	static constexpr std::array<float, 5> BLUR{1.0f / 16, 4.0f / 16, 6.0f / 16, 4.0f / 16, 1.0f / 16};
+	std::vector<float> smooth(envelope.size(), 0.0f);
+	for (size_t i = 0; i < envelope.size(); i++) {
+		for (size_t k = 0; k < BLUR.size(); k++) {
+			const auto j = i + k;
+			if (j >= BLUR.size() / 2 && j - BLUR.size() / 2 < envelope.size()) smooth[i] += BLUR[k] * envelope[j - BLUR.size() / 2];
+		}
+	}
+
+	std::vector<float> correlation(maxLag * 2 + 2, 0.0f);
+	for (auto lag = minLag / 2; lag < correlation.size(); lag++) {
+		auto sum = 0.0f;
+		for (size_t i = 0; i + lag < smooth.size(); i++) sum += smooth[i] * smooth[i + lag];
+		correlation[lag] = sum / static_cast<float>(smooth.size() - lag);
+	}
+
+	auto best = minLag;
+	auto bestScore = -1.0f;
+	for (auto lag = minLag; lag < maxLag; lag++) {
+		const auto bar = std::max({correlation[lag * 2 - 1], correlation[lag * 2], correlation[lag * 2 + 1]});
+		const auto off = std::max(correlation[lag / 2], correlation[(lag + 1) / 2]);
+		const auto octaves = std::log2(hopsPerSecond * 60.0f / static_cast<float>(lag) / PREFERRED_BPM);
+		const auto score = (correlation[lag] + 0.5f * (bar + off)) * std::exp(-0.5f * octaves * octaves);
+		if (score <= bestScore) continue;
+		best = lag;
+		bestScore = score;
+	}
+
+	// The peak is usually between two lags
+	const auto before = correlation[best - 1];
+	const auto at = correlation[best];
+	const auto after = correlation[best + 1];
+	const auto curve = before - 2.0f * at + after;
+	const auto shift = curve < 0.0f ? 0.5f * (before - after) / curve : 0.0f;
+	return static_cast<float>(best) + std::max(-0.5f, std::min(0.5f, shift));
+}
+
+// Dynamic programming over the envelope: each beat is scored by its onset plus the
+// best earlier beat, less how far the gap between them strays from the period.
+static std::vector<size_t> trackBeats(const std::vector<float>& envelope, const float period) {
+	const auto count = envelope.size();
+	const auto shortest = static_cast<size_t>(std::max(1.0f, std::round(period / 2.0f)));
+	const auto longest = static_cast<size_t>(std::round(period * 2.0f));
+
+	std::vector<float> score(count);
+	std::vector<long> back(count, -1);
+	for (size_t t = 0; t < count; t++) {
+		auto best = 0.0f;
+		for (auto gap = shortest; gap <= longest && gap <= t; gap++) {
+			const auto stray = std::log(static_cast<float>(gap) / period);
+			const auto candidate = score[t - gap] - TIGHTNESS * stray * stray;
+			if (candidate <= best) continue;
+			best = candidate;
+			back[t] = static_cast<long>(t - gap);
+		}
+
+		score[t] = envelope[t] + best;
+	}
+
+	// The song may end between beats, so the last one is somewhere in the last gap
+	const auto tail = count > longest ? count - longest : 0;
+	auto last = static_cast<long>(std::max_element(score.begin() + static_cast<std::ptrdiff_t>(tail), score.end()) - score.begin());
+
+	std::vector<size_t> beats;
+	for (; last >= 0; last = back[last]) beats.push_back(static_cast<size_t>(last));
+	std::reverse(beats.begin(), beats.end());
+	return beats;
+}
+
+static bool label(const std::string& path, const std::string& output, std::string& summary) {
+	Analysis analysis;
+	if (!analyse(path, analysis)) {
+		summary = "cannot decode";
+		return false;
+	}
+
+	const auto hopsPerSecond = static_cast<float>(analysis.rate) / static_cast<float>(analysis.hop);
+	const auto envelope = normalise(analysis.flux, static_cast<size_t>(hopsPerSecond / 2.0f));
+	const auto period = findPeriod(envelope, hopsPerSecond);
+	auto beats = trackBeats(envelope, period);
+
+	const auto loudest = *std::max_element(analysis.energy.begin(), analysis.energy.end());
+	beats.erase(std::remove_if(beats.begin(), beats.end(), [&analysis, loudest](const size_t beat) {
+		return analysis.energy[beat] < loudest * SILENCE;
+	}), beats.end());
+
+	if (beats.size() < static_cast<size_t>(BEATS_PER_BAR)) {
+		summary = "no beat found";
+		return false;
+	}
+
+	// Bars start on whichever beat in four has the most kick drum
+	std::vector<float> phases(BEATS_PER_BAR, 0.0f);
+	for (size_t i = 0; i < beats.size(); i++) phases[i % BEATS_PER_BAR] += analysis.low[beats[i]];
+	const auto phase = static_cast<size_t>(std::max_element(phases.begin(), phases.end()) - phases.begin());
+
+	// Mean energy of every bar, starting with the beats before the first downbeat
+	std::vector<float> bars;
+	for (size_t first = 0; first < beats.size();) {
+		auto last = first + 1;
+		while (last < beats.size() && last % BEATS_PER_BAR != phase) last++;
+
+		const auto start = beats[first];
+		const auto end = last < beats.size() ? beats[last] : analysis.energy.size();
+		auto energy = 0.0f;
+		for (auto i = start; i < end; i++) energy += analysis.energy[i];
+		bars.push_back(energy / static_cast<float>(std::max<size_t>(end - start, 1)));
+		first = last;
+	}
+
+	auto sorted = bars;
+	std::nth_element(sorted.begin(), sorted.begin() + static_cast<std::ptrdiff_t>(sorted.size() / 2), sorted.end());
+	const auto median = sorted[sorted.size() / 2];
+
+	std::ofstream file(output, std::ios::out | std::ios::trunc);
+	if (!file) {
+		summary = "cannot write " + output;
+		return false;
+	}
+
+	const auto write = [&file](const float time, const char* name) {
+		char line[64];
+		std::snprintf(line, sizeof(line), "%f\t%f\t%s\n", time, time, name);
+		file << line;
+	};
+
+	auto bar = phase == 0 ? -1 : 0;
+	auto spun = -BARS_BETWEEN_SPINS;
+	for (size_t i = 0; i < beats.size(); i++) {
+		const auto time = analysis.getTime(beats[i]);
+		if (i % BEATS_PER_BAR != phase) {
+			write(time, "BS");
+			continue;
+		}
+
+		bar++;
+		if (bars[bar] < median) {
+			write(time, "BS");
+			continue;
+		}
+
+		auto before = 0.0f;
+		const auto history = std::min(bar, SPIN_HISTORY_BARS);
+		for (auto b = bar - history; b < bar; b++) before += bars[b];
+		// A bar cut short by the end of the song is mostly its downbeat, so it always looks loud
+		const auto whole = i + BEATS_PER_BAR <= beats.size();
+		if (whole && history && bars[bar] > SPIN_RISE * before / static_cast<float>(history) && bar - spun >= BARS_BETWEEN_SPINS) {
+			write(time, "S");
+			spun = bar;
+		}
+
+		write(time, "BL");
+		write(time, "I");
+	}
+
+	char line[64];
+	std::snprintf(line, sizeof(line), "%.1f bpm, %zu beats, %zu bars", hopsPerSecond * 60.0f / period, beats.size(), bars.size());
+	summary = line;
+	return static_cast<bool>(file);
+}
+
+int main(int argc, char** argv) {
+	auto overwrite = false;
+	std::vector<std::filesystem::path> songs;
+	for (auto i = 1; i < argc; i++) {
+		if (std::strcmp(argv[i], "-f") == 0) {
+			overwrite = true;
+			continue;
+		}
+
+		std::error_code error;
+		if (!std::filesystem::is_directory(argv[i], error)) {
+			songs.emplace_back(argv[i]);
+			continue;
+		}
+
+		for (const auto& entry : std::filesystem::directory_iterator(argv[i], error)) {
+			if (entry.path().extension() == ".ogg") songs.push_back(entry.path());
+		}
+	}
+
+	if (songs.empty()) {
+		std::fprintf(stderr, "usage: %s [-f] song.ogg|directory...\n", argv[0]);
+		return 1;
+	}
+
+	std::sort(songs.begin(), songs.end());
+
+	// Each song is independent, so every core takes the next one that is left
+	std::atomic<size_t> next{0};
+	std::atomic<bool> failed{false};
+	std::mutex print;
+	const auto work = [&] {
+		for (auto i = next++; i < songs.size(); i = next++) {
+			const auto& song = songs[i];
+			auto output = song;
+			output.replace_extension(".txt");
+
+			std::string summary = "already labelled";
+			auto ok = true;
+			if (overwrite || !std::filesystem::exists(output)) ok = label(song.string(), output.string(), summary);
+			if (!ok) failed = true;
+
+			std::lock_guard<std::mutex> lock(print);
+			std::fprintf(ok ? stdout : stderr, "%s: %s\n", song.string().c_str(), summary.c_str());
+		}
+	};
+
+	const auto cores = std::max(1u, std::thread::hardware_concurrency());
+	std::vector<std::thread> threads;
+	for (size_t i = 1; i < std::min<size_t>(cores, songs.size()); i++) threads.emplace_back(work);
+	work();
+	for (auto& thread : threads) thread.join();
+	return failed ? 1 : 0;
+}
@@ -0,0 +1,171 @@
+// Times the work the game splits across cores, once with every thread count
+// from one up to every core, so the thresholds in Game and the split in Load
+// can be checked on real hardware.
+//
+// The geometry test works out the quads of a field of walls far denser than
+// any stock level, the way Game::drawPatterns does. Given level files, the
+// load test also reads copies of them side by side, the way Load::enter reads
+// the files it finds.
+//
+// Usage: JobsBench [-w walls] [-f frames] [-c copies] [levels.haxagon...]
+
+#include "Core/AudioLoader.hpp"
+#include "Core/Font.hpp"
+#include "Core/Game.hpp"
+#include "Core/Jobs.hpp"
+#include "Core/Platform.hpp"
+#include "Core/Twist.hpp"
+#include "Factories/LevelFactory.hpp"
+#include "Objects/Wall.hpp"
+#include "States/Load.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace SuperHaxagon;
+
+// Only what the factories touch, which is messages and memory
+class BenchPlatform : public Platform {
+public:
+	BenchPlatform() : Platform(Dbg::WARN) {
+		_logger.setLevel(Dbg::WARN);
+	}
+
+	bool loop() override {return true;}
+	float getDilation() override {return 1.0f;}
+
+	std::string getPath(const std::string& partial, Location) override {return partial;}
+	std::unique_ptr<AudioLoader> loadAudio(const std::string&, Stream, Location) override {return nullptr;}
+	std::unique_ptr<Font> loadFont(const std::string&, int) override {return nullptr;}
+
+	void playSFX(AudioLoader&) override {}
+
+	std::string getButtonName(const Buttons&) override {return "";}
+	Buttons getPressed() override {return {};}
+	Point getScreenDim() const override {return {1280, 720};}
+
+	void screenBegin() override {}
+	void screenFinalize() override {}
+	void drawPoly(const Color&, const std::vector<Point>&) override {}
+
+	std::unique_ptr<Twist> getTwister() override {return nullptr;}
+
+	void shutdown() override {}
+
+protected:
+	void output(Dbg, const std::string& where, const std::string& message) override {
+		std::fprintf(stderr, "%s: %s\n", where.c_str(), message.c_str());
+	}
+};
+
+static double seconds(const std::chrono::steady_clock::time_point start) {
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Runs test with every thread count and prints how it scales against one
+static void scale(const char* name, const char* unit, const size_t cores, const std::function<double(Jobs&)>& test) {
+	std::printf("%s\n", name);
+	auto single = 0.0;
+	for (size_t threads = 1; threads <= cores; threads++) {
+		Jobs jobs(threads);
+		test(jobs); // Warm up, so the threads are running and memory is touched
+		const auto taken = test(jobs);
+		if (threads == 1) single = taken;
+		std::printf("  %2zu threads %9.3f %s  x%.2f\n", threads, taken * 1000.0, unit, single / taken);
+	}
+}
+
+static double geometry(Jobs& jobs, const std::vector<Wall>& walls, std::vector<std::vector<Point>>& quads, const int frames) {
+	const Point focus{640, 360};
+	const auto start = std::chrono::steady_clock::now();
+	for (auto frame = 0; frame < frames; frame++) {
+		const auto rotation = static_cast<float>(frame) * 0.01f;
+		jobs.parallelFor(walls.size(), Game::WALL_GRAIN, [&](const size_t begin, const size_t end) {
+			for (auto i = begin; i < end; i++) walls[i].calcPoints(quads[i], focus, rotation, 6.0f, 0.0f, 1.0f);
+		});
+	}
+
+	return seconds(start) / frames;
+}
+
+static double load(Jobs& jobs, BenchPlatform& platform, const std::vector<std::string>& files, const int copies) {
+	const auto count = files.size() * copies;
+	std::vector<std::vector<std::unique_ptr<LevelFactory>>> packs(count);
+	const auto start = std::chrono::steady_clock::now();
+	jobs.parallelFor(count, 1, [&](const size_t begin, const size_t end) {
+		for (auto i = begin; i < end; i++) {
+			std::istringstream stream(files[i % files.size()]);
+			Load::loadLevels(stream, Location::USER, platform, packs[i]);
+		}
+	});
+
+	return seconds(start);
+}
+
+int main(int argc, char** argv) {
+	size_t walls = 8192;
+	auto frames = 600;
+	auto copies = 16;
+	std::vector<std::string> files;
+	for (auto i = 1; i < argc; i++) {
+		if (std::strcmp(argv[i], "-w") == 0 && i + 1 < argc) {
+			walls = std::strtoul(argv[++i], nullptr, 10);
+			continue;
+		}
+
+		if (std::strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
+			frames = std::max(std::atoi(argv[++i]), 1);
+			continue;
+		}
+
+		if (std::strcmp(argv[i], "-c") == 0 && i + 1 < argc) {
+			copies = std::max(std::atoi(argv[++i]), 1);
+			continue;
+		}
+
+		if (argv[i][0] == '-') {
+			std::fprintf(stderr, "usage: %s [-w walls] [-f frames] [-c copies] [levels.haxagon...]\n", argv[0]);
+			return 1;
+		}
+
+		std::ifstream file(argv[i], std::ios::in | std::ios::binary);
+		if (!file) {
+			std::fprintf(stderr, "%s: cannot read\n", argv[i]);
+			return 1;
+		}
+
+		files.emplace_back(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	}
+
+	const auto cores = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+	std::printf("%zu cores, walls split from %zu at %zu a chunk\n\n", cores, Game::PARALLEL_WALLS, Game::WALL_GRAIN);
+
+	// Rings of walls on every side, spaced out like a fast pattern
+	std::vector<Wall> field;
+	field.reserve(walls);
+	for (size_t i = 0; i < walls; i++) field.emplace_back(static_cast<float>(i / 6) * 4.0f, 20.0f, static_cast<int>(i % 6));
+	std::vector<std::vector<Point>> quads(walls);
+
+	char title[64];
+	std::snprintf(title, sizeof(title), "geometry, %zu walls", walls);
+	scale(title, "ms a frame", cores, [&](Jobs& jobs) {return geometry(jobs, field, quads, frames);});
+
+	if (!files.empty()) {
+		BenchPlatform platform;
+		std::printf("\n");
+		std::snprintf(title, sizeof(title), "load, %zu files", files.size() * copies);
+		scale(title, "ms", cores, [&](Jobs& jobs) {return load(jobs, platform, files, copies);});
+	}
+
+	return 0;
+}
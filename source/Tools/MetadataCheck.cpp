@@ -0,0 +1,45 @@
+// Checks that a label file full of labels the game does not know cannot take
+// the bits of the ones it acts on, so spins and pulses still fire after any
+// number of custom packs have been read.
+//
+// Usage: MetadataCheck
+
+#include "Core/Metadata.hpp"
+
+#include <cstdio>
+#include <memory>
+#include <sstream>
+#include <string>
+
+using namespace SuperHaxagon;
+
+static bool check(const bool ok, const char* what) {
+	if (!ok) std::printf("failed: %s\n", what);
+	return ok;
+}
+
+int main() {
+	// Far more labels than there are bits, all before the one that matters
+	std::string text;
+	for (auto i = 0; i < Metadata::MAX_EVENTS * 2; i++) {
+		text += std::to_string(i * 0.01f) + "\t" + std::to_string(i * 0.01f) + "\tCUSTOM" + std::to_string(i) + "\n";
+	}
+
+	text += "5.000000\t5.000000\tS\n";
+	text += "6.000000\t6.000000\tL3\n";
+
+	Metadata metadata(std::make_unique<std::istringstream>(text));
+	const auto spin = Metadata::getEvent("S");
+	const auto level = Metadata::getEvent("L3");
+
+	auto ok = check(spin != 0, "S has a bit");
+	ok &= check(level != 0 && level != spin, "L3 has a bit of its own");
+	ok &= check(Metadata::getEvent("CUSTOM0") == 0, "unknown labels have no bit");
+	ok &= check(Metadata(std::make_unique<std::istringstream>("1.0\t1.0\tCUSTOM\n")).getMaxTime() == 0.0f, "unknown labels are dropped");
+	ok &= check(metadata.advance(4.0f) == 0, "nothing fires before S");
+	ok &= check(metadata.advance(5.5f) == spin, "S fires");
+	ok &= check(metadata.advance(7.0f) == level, "L3 fires");
+
+	if (ok) std::printf("ok\n");
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,248 @@
+// Plays sounds through the core mixer with no audio device attached and
+// reports how much of real time mixing took and how often the device ran dry.
+//
+// With -l it instead plays a click again and again and listens for it coming
+// out of the sink, reporting how long the mixer takes from play() to the
+// speakers and how far the voice's clock is from what is being heard.
+//
+// With -a the sounds are packed into IMA ADPCM first and played compressed,
+// after a report of how much memory that saves and how much noise it adds.
+//
+// Usage: MixerBench [-a] [-o out.wav] [-s seconds] sound.wav...
+//        MixerBench -l
+
+#include "Core/AudioSink.hpp"
+#include "Core/Mixer.hpp"
+#include "Core/Sound.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace SuperHaxagon;
+
+static constexpr int LOOPBACK_TRIALS = 20;
+
+static int64_t now() {
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Stamps when the first loud frame after arm() comes out of the device
+class Loopback : public AudioSink {
+public:
+	static constexpr int THRESHOLD = 64;
+
+	explicit Loopback(Mixer& mixer) : AudioSink(mixer) {
+		start();
+	}
+
+	~Loopback() override {
+		stop();
+	}
+
+	void arm() {
+		_heard.store(0, std::memory_order_relaxed);
+		_armed.store(true, std::memory_order_release);
+	}
+
+	// In steady clock nanoseconds, or 0 if the device has not reached it yet
+	int64_t getHeard() const {return _heard.load(std::memory_order_acquire);}
+
+protected:
+	void consume(const int16_t* samples, const size_t frames) override {
+		if (!_armed.load(std::memory_order_acquire)) return;
+		for (size_t i = 0; i < frames; i++) {
+			if (std::abs(samples[i * Mixer::CHANNELS]) < THRESHOLD) continue;
+
+			// The device starts on this period once it is done with the last one
+			const auto offset = static_cast<double>(PERIOD_FRAMES + i) / _mixer.getRate();
+			_armed.store(false, std::memory_order_relaxed);
+			_heard.store(now() + static_cast<int64_t>(offset * 1e9), std::memory_order_release);
+			return;
+		}
+	}
+
+private:
+	std::atomic<bool> _armed{false};
+	std::atomic<int64_t> _heard{0};
+};
+
+static int loopback() {
+	Mixer mixer(44100, 4096);
+	Loopback sink(mixer);
+
+	// A quarter second square wave, loud from its very first frame
+	auto click = std::make_shared<Sound>();
+	click->rate = mixer.getRate();
+	click->channels = 1;
+	click->samples.resize(static_cast<size_t>(click->rate / 4));
+	for (size_t i = 0; i < click->samples.size(); i++) click->samples[i] = (i / 50) % 2 ? 8000 : -8000;
+
+	std::vector<double> latencies;
+	std::vector<double> errors;
+	for (auto trial = 0; trial < LOOPBACK_TRIALS; trial++) {
+		sink.arm();
+		const auto played = now();
+		const auto voice = mixer.play(click, false);
+		if (voice < 0) continue;
+
+		const auto timeout = played + 1000000000;
+		while (!sink.getHeard() && now() < timeout) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		const auto heard = sink.getHeard();
+		if (!heard) {
+			std::fprintf(stderr, "click was never heard\n");
+			return 1;
+		}
+
+		// Partway into the click, the clock should say how much of it has been heard
+		std::this_thread::sleep_until(std::chrono::steady_clock::time_point(std::chrono::nanoseconds(heard + 100000000)));
+		const auto clock = mixer.getTime(voice);
+		const auto expected = static_cast<double>(now() - heard) / 1e9;
+		latencies.push_back(static_cast<double>(heard - played) / 1e6);
+		errors.push_back((clock - expected) * 1000.0);
+
+		// Let it finish so every trial starts from silence
+		std::this_thread::sleep_for(std::chrono::milliseconds(300));
+	}
+
+	if (latencies.empty()) return 1;
+	std::sort(latencies.begin(), latencies.end());
+	auto total = 0.0;
+	auto worst = 0.0;
+	for (const auto latency : latencies) total += latency;
+	for (const auto error : errors) worst = std::max(worst, std::fabs(error));
+	std::printf("latency min %.1f ms, median %.1f ms, max %.1f ms, avg %.1f ms, clock error max %.1f ms\n",
+		latencies.front(), latencies[latencies.size() / 2], latencies.back(), total / latencies.size(), worst);
+	return 0;
+}
+
+// Prints the memory each sound takes as PCM and as ADPCM, and how far above
+// the noise the compression adds the sound still is
+static void report(const std::vector<std::string>& names, const std::vector<std::shared_ptr<const Sound>>& pcm, const std::vector<std::shared_ptr<const Sound>>& adpcm) {
+	size_t totalPcm = 0;
+	size_t totalAdpcm = 0;
+	for (size_t i = 0; i < pcm.size(); i++) {
+		const auto& original = *pcm[i];
+		const auto& compressed = *adpcm[i];
+		std::vector<int16_t> block(compressed.getBlockFrames() * compressed.channels);
+		auto signal = 0.0;
+		auto noise = 0.0;
+		size_t frame = 0;
+		for (size_t b = 0; b < compressed.getBlocks(); b++) {
+			const auto frames = decodeAdpcm(compressed, b, block.data());
+			for (size_t s = 0; s < frames * compressed.channels; s++) {
+				const auto a = static_cast<double>(original.samples[frame * original.channels + s]);
+				const auto d = a - block[s];
+				signal += a * a;
+				noise += d * d;
+			}
+
+			frame += frames;
+		}
+
+		const auto snr = noise > 0 ? 10.0 * std::log10(signal / noise) : 0.0;
+		std::printf("%-32s pcm %8zu bytes, adpcm %8zu bytes, snr %5.1f dB\n", names[i].c_str(), original.getBytes(), compressed.getBytes(), snr);
+		totalPcm += original.getBytes();
+		totalAdpcm += compressed.getBytes();
+	}
+
+	std::printf("%-32s pcm %8zu bytes, adpcm %8zu bytes, saved %.1f%%\n", "total", totalPcm, totalAdpcm,
+		totalPcm ? 100.0 * (1.0 - static_cast<double>(totalAdpcm) / static_cast<double>(totalPcm)) : 0.0);
+}
+
+int main(int argc, char** argv) {
+	if (argc == 2 && std::strcmp(argv[1], "-l") == 0) return loopback();
+
+	std::string output;
+	auto seconds = 10.0;
+	auto adpcm = false;
+	std::vector<std::string> names;
+	std::vector<std::shared_ptr<const Sound>> sounds;
+	for (auto i = 1; i < argc; i++) {
+		if (std::strcmp(argv[i], "-a") == 0) {
+			adpcm = true;
+			continue;
+		}
+
+		if (std::strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+			output = argv[++i];
+			continue;
+		}
+
+		if (std::strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+			seconds = std::atof(argv[++i]);
+			continue;
+		}
+
+		std::ifstream file(argv[i], std::ios::in | std::ios::binary);
+		auto sound = loadWav(file);
+		if (!sound) {
+			std::fprintf(stderr, "%s: not a 16 bit PCM wav\n", argv[i]);
+			return 1;
+		}
+
+		names.emplace_back(argv[i]);
+		sounds.emplace_back(std::move(sound));
+	}
+
+	if (sounds.empty()) {
+		std::fprintf(stderr, "usage: %s [-a] [-o out.wav] [-s seconds] sound.wav...\n       %s -l\n", argv[0], argv[0]);
+		return 1;
+	}
+
+	if (adpcm) {
+		std::vector<std::shared_ptr<const Sound>> compressed;
+		for (size_t i = 0; i < sounds.size(); i++) {
+			if (sounds[i]->isCompressed()) {
+				std::fprintf(stderr, "%s: already compressed\n", names[i].c_str());
+				return 1;
+			}
+
+			compressed.emplace_back(compressAdpcm(*sounds[i]));
+		}
+
+		report(names, sounds, compressed);
+		sounds = std::move(compressed);
+	}
+
+	// Same rate and latency the handhelds use
+	Mixer mixer(44100, 4096);
+	std::unique_ptr<AudioSink> sink;
+	if (output.empty()) {
+		sink = std::make_unique<NullSink>(mixer);
+	} else {
+		auto wav = std::make_unique<WavSink>(mixer, output);
+		if (!wav->isOpen()) {
+			std::fprintf(stderr, "%s: cannot write\n", output.c_str());
+			return 1;
+		}
+
+		sink = std::move(wav);
+	}
+
+	// Retrigger every sound like a busy game would, roughly every 60 ms
+	const auto start = std::chrono::steady_clock::now();
+	const std::chrono::duration<double> length(seconds);
+	auto peak = 0.0f;
+	size_t next = 0;
+	while (std::chrono::steady_clock::now() - start < length) {
+		mixer.play(sounds[next++ % sounds.size()], false, 0.5f);
+		std::this_thread::sleep_for(std::chrono::milliseconds(60));
+		if (mixer.getLoad() > peak) peak = mixer.getLoad();
+	}
+
+	const auto frames = sink->getFrames();
+	sink = nullptr;
+	std::printf("frames %llu, underruns %u, load %.3f%%, peak %.3f%%\n",
+		static_cast<unsigned long long>(frames), mixer.getUnderruns(), mixer.getLoad() * 100.0f, peak * 100.0f);
+	return 0;
+}